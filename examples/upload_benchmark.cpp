@@ -0,0 +1,100 @@
+/*
+ * upload_benchmark.cpp
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: nemikolh
+ *
+ *  This example compares the ways of filling a gl_vector with
+ *  100 MB of data. The first one copies the data with std::copy
+ *  while the vector is mapped, element by element. The others
+ *  use gl_vector::append and gl_vector::write, which write large
+ *  blocks with non-temporal stores, whole cache lines at once, in
+ *  the write-combined memory of the mapped buffer.
+ *  With a software renderer, the mapped memory is ordinary cached
+ *  memory, the difference is then much smaller than with a GPU.
+ *  As in the other examples, the SFML is only used to get a context.
+ */
+
+#include <iostream>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+#include <SFML/Graphics.hpp>
+
+#include "../mgl/glrequires.hpp"
+/* The gl_vector and the gl_scope to map it. */
+#include "../mgl/glvector.hpp"
+#include "../mgl/glscope.hpp"
+
+namespace {
+
+const std::size_t upload_size = 100 * 1024 * 1024 / sizeof(float);
+const int         runs        = 5;
+
+template<typename F>
+double best_of(F p_upload)
+{
+    double best = 1e9;
+    // ------------------------- DECLARE ------------------------ //
+
+    for(int i = 0; i < runs; ++i)
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+        p_upload();
+        // Wait for the driver, the unmap may be deferred.
+        glFinish();
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::high_resolution_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+}
+
+int main(int argc, char **argv)
+{
+    // ------------------------- Window Creation ------------------------ //
+    sf::ContextSettings settings;
+    settings.majorVersion = 3;
+    settings.minorVersion = 3;
+    std::unique_ptr<sf::Window> window(new sf::Window(sf::VideoMode(800, 600), "Upload benchmark", sf::Style::Default, settings));
+    window->setVisible(false);
+
+    // -------------------- Loading OpenGL functions -------------------- //
+    GLenum err = glewInit();
+    if (GLEW_OK != err)
+    {
+        std::cerr << "GLEW error: " << glewGetErrorString(err) << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // -------------------------- data creation ------------------------- //
+    std::vector<float> source(upload_size);
+    for(std::size_t i = 0; i < source.size(); ++i)
+        source[i] = float(i);
+
+    // Both vectors own their buffer before the measures, only the copy is timed.
+    mgl::gl_vector<float> copied(upload_size);
+    mgl::gl_vector<float> appended;
+    appended.reserve(upload_size);
+
+    // --------------------------- measures ----------------------------- //
+    double copy_ms = best_of([&]() {
+        mgl::gl_scope<mgl::gl_vector<float>> lock(copied);
+        std::copy(source.begin(), source.end(), copied.begin());
+    });
+
+    double append_ms = best_of([&]() {
+        appended.clear();
+        appended.append(source.data(), source.size());
+    });
+
+    double write_ms = best_of([&]() {
+        appended.write(0, source.data(), source.size());
+    });
+
+    std::cout << "std::copy in the mapped buffer:  " << copy_ms   << " ms" << std::endl;
+    std::cout << "gl_vector::append:               " << append_ms << " ms" << std::endl;
+    std::cout << "gl_vector::write:                " << write_ms  << " ms" << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -27,6 +27,7 @@ std::string src_pass_through_shader(shader_type p_type)
     {
         case shader_type::VERTEX_SHADER:
             ins.set_qualifier("in");
+            ins.set_explicit_location(attribute_location_base<T>::value);
             outs.set_qualifier("smooth out");
             outs.set_prefix("frag_in_");
             outs.set_test(ignore_first);
@@ -0,0 +1,426 @@
+/*
+ * frustum_culling.hpp
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: nemikolh
+ */
+
+#ifndef EXTENSION_FRUSTUM_CULLING_HPP_
+#define EXTENSION_FRUSTUM_CULLING_HPP_
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <type_traits>
+#include <glm/glm.hpp>
+#include "../glvector.hpp"
+#include "../glexceptions.hpp"
+#include "../meta/gliterdata.hpp"
+#include "../type/gldrawcommand.hpp"
+#include "priv/cull_kernel.hpp"
+#include "priv/worker_pool.hpp"
+
+namespace mgl {
+namespace extension {
+
+/**
+ * @brief The 6 planes of a view frustum, normals pointing inside.
+ */
+struct frustum
+{
+    // ================================================================ //
+    // ============================ METHODS =========================== //
+    // ================================================================ //
+
+    /**
+     * @brief Extract the planes of the passed matrix (Gribb-Hartmann).
+     * @param p_view_projection is the projection matrix times the view matrix,
+     *        or times the model matrix too to cull in model space.
+     */
+    static frustum from_matrix(const glm::mat4& p_view_projection)
+    {
+        const glm::mat4& m = p_view_projection;
+        glm::vec4 row[4];
+        frustum f;
+        // ------------------------- DECLARE ------------------------ //
+
+        for(int i = 0; i < 4; ++i)
+            row[i] = glm::vec4(m[0][i], m[1][i], m[2][i], m[3][i]);
+        f.planes[0] = row[3] + row[0];  // left
+        f.planes[1] = row[3] - row[0];  // right
+        f.planes[2] = row[3] + row[1];  // bottom
+        f.planes[3] = row[3] - row[1];  // top
+        f.planes[4] = row[3] + row[2];  // near
+        f.planes[5] = row[3] - row[2];  // far
+        for(glm::vec4& plane : f.planes)
+            plane /= glm::length(glm::vec3(plane));
+        return f;
+    }
+
+    /**
+     * @brief Returns true when the box is at least partly inside the frustum.
+     * @param p_center is the center of the box.
+     * @param p_extent is the half size of the box.
+     */
+    bool intersects(const glm::vec3& p_center, const glm::vec3& p_extent) const
+    {
+        for(const glm::vec4& plane : planes)
+            if(glm::dot(glm::vec3(plane), p_center) + glm::dot(glm::abs(glm::vec3(plane)), p_extent) + plane.w < 0.f)
+                return false;
+        return true;
+    }
+
+    // ================================================================ //
+    // ============================= FIELDS =========================== //
+    // ================================================================ //
+
+    /** Left, right, bottom, top, near and far planes. */
+    glm::vec4 planes[6];
+};
+
+/**
+ * @brief instance_bounds stores one axis aligned box per instance, as structure of arrays.
+ *
+ * Spheres are stored as the box containing them, which is conservative.
+ */
+class instance_bounds
+{
+public:
+    // ================================================================ //
+    // =========================== CTOR/DTOR ========================== //
+    // ================================================================ //
+
+    instance_bounds()
+        : m_cx(), m_cy(), m_cz()
+        , m_ex(), m_ey(), m_ez()
+    {}
+
+    // ================================================================ //
+    // ============================ METHODS =========================== //
+    // ================================================================ //
+
+    /**
+     * @brief Add the box [p_min, p_max].
+     */
+    void push_box(const glm::vec3& p_min, const glm::vec3& p_max)
+    {
+        push(0.5f * (p_min + p_max), 0.5f * (p_max - p_min));
+    }
+
+    /**
+     * @brief Add the sphere of center p_center and radius p_radius.
+     */
+    void push_sphere(const glm::vec3& p_center, float p_radius)
+    {
+        push(p_center, glm::vec3(p_radius));
+    }
+
+    /**
+     * @brief Replace the bounds by a box of half size p_extent around
+     *        the N-th attribute of each element of p_instances.
+     *
+     * The vector is mapped while reading, the attribute must be a glm::vec3.
+     *  @code
+     *      MGL_DEFINE_GL_ATTRIBUTES(, instance, (glm::vec3, position)(glm::vec4, color))
+     *      bounds.assign<0>(instances, glm::vec3(radius));
+     *  @endcode
+     */
+    template<unsigned int N, typename T, typename B>
+    void assign(const gl_vector<T, B>& p_instances, const glm::vec3& p_extent)
+    {
+        static_assert(mgl::priv::is_gl_attributes<T>::value, "T must be declared with MGL_DEFINE_GL_ATTRIBUTES.");
+        static_assert(std::is_same<typename value_at<T, N>::type, glm::vec3>::value, "The attribute must be a glm::vec3.");
+        assign_at(p_instances, offset_at<T, N>::value, p_extent);
+    }
+
+    /**
+     * @brief Same as assign<N>() with the attribute found from its name.
+     * @throw gl_exception_specific if T has no glm::vec3 attribute named p_name.
+     */
+    template<typename T, typename B>
+    void assign(const gl_vector<T, B>& p_instances, const char* p_name, const glm::vec3& p_extent)
+    {
+        static_assert(mgl::priv::is_gl_attributes<T>::value, "T must be declared with MGL_DEFINE_GL_ATTRIBUTES.");
+        find_position<T> finder{mgl::priv::hash_str(p_name), 0, false};
+        // ------------------------- DECLARE ------------------------ //
+
+        mgl::for_each<T>::apply(finder);
+        if(!finder.found)
+            throw gl_exception_specific("no glm::vec3 attribute named ", p_name);
+        assign_at(p_instances, finder.offset, p_extent);
+    }
+
+    /**
+     * @brief Remove all the bounds.
+     */
+    void clear()
+    {
+        for(std::vector<float>* v : { &m_cx, &m_cy, &m_cz, &m_ex, &m_ey, &m_ez })
+            v->clear();
+    }
+
+    /**
+     * @brief Reserve the memory for p_n instances.
+     */
+    void reserve(std::size_t p_n)
+    {
+        for(std::vector<float>* v : { &m_cx, &m_cy, &m_cz, &m_ex, &m_ey, &m_ez })
+            v->reserve(p_n);
+    }
+
+    /**
+     * @brief Returns the number of instances.
+     */
+    std::size_t size() const
+    {
+        return m_cx.size();
+    }
+
+    /**
+     * @brief Returns the arrays read by the culling kernel.
+     */
+    priv::cull_boxes boxes() const
+    {
+        return priv::cull_boxes{ m_cx.data(), m_cy.data(), m_cz.data(), m_ex.data(), m_ey.data(), m_ez.data() };
+    }
+
+private:
+
+    /**
+     * @brief Functor used with mgl::for_each to find the offset of a glm::vec3 attribute.
+     */
+    template<typename T>
+    struct find_position
+    {
+        template<typename E, std::size_t N>
+        void apply(const char*)
+        {
+            if(!found && struct_member_name<T, N>::hash == hash && std::is_same<E, glm::vec3>::value)
+            {
+                offset = offset_at<T, N>::value;
+                found  = true;
+            }
+        }
+
+        std::uint32_t hash;
+        std::size_t   offset;
+        bool          found;
+    };
+
+    // ================================================================ //
+    // ============================ METHODS =========================== //
+    // ================================================================ //
+
+    void push(const glm::vec3& p_center, const glm::vec3& p_extent)
+    {
+        m_cx.push_back(p_center.x);
+        m_cy.push_back(p_center.y);
+        m_cz.push_back(p_center.z);
+        m_ex.push_back(p_extent.x);
+        m_ey.push_back(p_extent.y);
+        m_ez.push_back(p_extent.z);
+    }
+
+    template<typename T, typename B>
+    void assign_at(const gl_vector<T, B>& p_instances, std::size_t p_offset, const glm::vec3& p_extent)
+    {
+        gl_scope<gl_vector<T, B>> mapped(p_instances);
+        const char* it = reinterpret_cast<const char*>(p_instances.data()) + p_offset;
+        // ------------------------- DECLARE ------------------------ //
+
+        clear();
+        reserve(p_instances.size());
+        for(std::size_t i = 0; i < p_instances.size(); ++i, it += sizeof(T))
+            push(*reinterpret_cast<const glm::vec3*>(it), p_extent);
+    }
+
+    // ================================================================ //
+    // ============================= FIELDS =========================== //
+    // ================================================================ //
+
+    /** Centers of the boxes. */
+    std::vector<float> m_cx, m_cy, m_cz;
+    /** Half sizes of the boxes. */
+    std::vector<float> m_ex, m_ey, m_ez;
+};
+
+/**
+ * @brief frustum_culler tests instance_bounds against a frustum before the draw is submitted.
+ *
+ * The instances are split in chunks tested by several threads, 8 boxes at a time when compiled
+ * with AVX2 (define MGL_NO_SIMD to force the scalar path). The results are written straight into
+ * the mapped output vector, then compacted. The threads are kept by the culler between the calls,
+ * so a culler must not be used by several threads at once.
+ *  @code
+ *      mgl::extension::frustum_culler culler;
+ *      bounds.assign<0>(instances, glm::vec3(radius));
+ *      // Either the ids of the visible instances, read by the vertex shader...
+ *      culler.cull(mgl::extension::frustum::from_matrix(proj * view), bounds, visible_ids);
+ *      // ... or the indirect commands drawing them.
+ *      culler.cull(mgl::extension::frustum::from_matrix(proj * view), bounds, commands, mesh_command);
+ *      mgl::gl_draw_indirect(vao, commands);
+ *  @endcode
+ */
+class frustum_culler
+{
+public:
+    // ================================================================ //
+    // =========================== CTOR/DTOR ========================== //
+    // ================================================================ //
+
+    /**
+     * @brief Constructor.
+     * @param p_threads is the number of threads used to cull, all the cores by default.
+     */
+    explicit frustum_culler(unsigned int p_threads = std::thread::hardware_concurrency())
+        : m_pool(p_threads)
+    {}
+
+    // ================================================================ //
+    // ============================ METHODS =========================== //
+    // ================================================================ //
+
+    /**
+     * @brief Write the indices of the visible instances, in increasing order.
+     * @param p_out must have room for p_bounds.size() indices.
+     * @return Returns the number of visible instances.
+     */
+    std::size_t cull(const frustum& p_frustum, const instance_bounds& p_bounds, std::uint32_t* p_out) const
+    {
+        return run(p_frustum, p_bounds, p_out, [](std::uint32_t* p_chunk, std::size_t p_first, std::size_t p_last,
+                                                  const float* p_planes, const priv::cull_boxes& p_boxes)
+        {
+            std::size_t count = 0;
+            priv::cull_boxes_range(p_planes, p_boxes, p_first, p_last, [&](std::size_t i)
+            {
+                p_chunk[count++] = static_cast<std::uint32_t>(i);
+            });
+            return count;
+        });
+    }
+
+    /**
+     * @brief Replace the content of p_visible by the indices of the visible instances.
+     * @return Returns the number of visible instances.
+     */
+    template<typename B>
+    std::size_t cull(const frustum& p_frustum, const instance_bounds& p_bounds, gl_vector<std::uint32_t, B>& p_visible) const
+    {
+        p_visible.resize(p_bounds.size());
+        std::size_t count = 0;
+        {
+            gl_scope<gl_vector<std::uint32_t, B>> mapped(p_visible);
+            count = cull(p_frustum, p_bounds, p_visible.data());
+        }
+        p_visible.resize(count);
+        return count;
+    }
+
+    /**
+     * @brief Write the commands drawing the visible instances of a mesh.
+     *
+     * Each run of consecutive visible instances becomes one command, copied from p_command
+     * with its instance_count and base_instance replaced.
+     * @param p_out must have room for p_bounds.size() commands.
+     * @return Returns the number of commands.
+     */
+    std::size_t cull(const frustum& p_frustum, const instance_bounds& p_bounds,
+                     draw_elements_indirect_command* p_out, const draw_elements_indirect_command& p_command) const
+    {
+        return run(p_frustum, p_bounds, p_out, [&p_command](draw_elements_indirect_command* p_chunk,
+                                                            std::size_t p_first, std::size_t p_last,
+                                                            const float* p_planes, const priv::cull_boxes& p_boxes)
+        {
+            std::size_t count = 0;
+            priv::cull_boxes_range(p_planes, p_boxes, p_first, p_last, [&](std::size_t i)
+            {
+                draw_elements_indirect_command* last = count ? p_chunk + count - 1 : nullptr;
+                if(last && last->base_instance + last->instance_count == i)
+                {
+                    ++last->instance_count;
+                    return;
+                }
+                p_chunk[count] = p_command;
+                p_chunk[count].instance_count = 1;
+                p_chunk[count].base_instance  = static_cast<GLuint>(i);
+                ++count;
+            });
+            return count;
+        });
+    }
+
+    /**
+     * @brief Replace the content of p_commands by the commands drawing the visible instances.
+     * @return Returns the number of commands.
+     */
+    template<typename B>
+    std::size_t cull(const frustum& p_frustum, const instance_bounds& p_bounds,
+                     gl_vector<draw_elements_indirect_command, B>& p_commands,
+                     const draw_elements_indirect_command& p_command) const
+    {
+        p_commands.resize(p_bounds.size());
+        std::size_t count = 0;
+        {
+            gl_scope<gl_vector<draw_elements_indirect_command, B>> mapped(p_commands);
+            count = cull(p_frustum, p_bounds, p_commands.data(), p_command);
+        }
+        p_commands.resize(count);
+        return count;
+    }
+
+private:
+
+    // ================================================================ //
+    // ============================ METHODS =========================== //
+    // ================================================================ //
+
+    /**
+     * Run p_chunk(out + first, first, last, planes, boxes) for each chunk, each writing at most
+     * last - first results at the start of its own part of p_out, then pack the results.
+     */
+    template<typename Out, typename Chunk>
+    std::size_t run(const frustum& p_frustum, const instance_bounds& p_bounds, Out* p_out, Chunk p_chunk) const
+    {
+        // Below this size per thread, the threads cost more than they save.
+        constexpr std::size_t min_chunk = 1 << 14;
+        const std::size_t n = p_bounds.size();
+        const std::size_t threads = std::max<std::size_t>(1, std::min<std::size_t>(m_pool.size(), n / min_chunk));
+        // Multiple of 8, so that only the last chunk has a scalar tail.
+        const std::size_t chunk = ((n + threads - 1) / threads + 7) & ~std::size_t(7);
+        const float* planes = &p_frustum.planes[0].x;
+        const priv::cull_boxes boxes = p_bounds.boxes();
+        std::vector<std::size_t> counts(threads, 0);
+        std::size_t total = 0;
+        // ------------------------- DECLARE ------------------------ //
+
+        m_pool.run(threads, [&](std::size_t t)
+        {
+            std::size_t first = std::min(n, t * chunk);
+            std::size_t last  = std::min(n, first + chunk);
+            counts[t] = p_chunk(p_out + first, first, last, planes, boxes);
+        });
+
+        for(std::size_t t = 0; t < threads; ++t)
+        {
+            Out* first = p_out + std::min(n, t * chunk);
+            if(first != p_out + total)
+                std::copy(first, first + counts[t], p_out + total);
+            total += counts[t];
+        }
+        return total;
+    }
+
+    // ================================================================ //
+    // ============================= FIELDS =========================== //
+    // ================================================================ //
+
+    /** The threads used to cull. */
+    mutable priv::worker_pool m_pool;
+};
+
+} /* namespace extension */
+} /* namespace mgl */
+
+#endif /* EXTENSION_FRUSTUM_CULLING_HPP_ */
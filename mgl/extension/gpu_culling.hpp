@@ -0,0 +1,321 @@
+/*
+ * gpu_culling.hpp
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: nemikolh
+ */
+
+#ifndef EXTENSION_GPU_CULLING_HPP_
+#define EXTENSION_GPU_CULLING_HPP_
+
+#include <cstdint>
+#include <cassert>
+#include <string>
+#include <glm/glm.hpp>
+#include "../glrequires.hpp"
+#include "../glvector.hpp"
+#include "../glexceptions.hpp"
+#include "../type/glprogram.hpp"
+#include "../type/gltexture.hpp"
+#include "../type/gldrawcommand.hpp"
+#include "frustum_culling.hpp"
+
+namespace mgl {
+namespace extension {
+
+/**
+ * @brief The box of an instance, as read by the culling compute shader (std430 layout).
+ */
+struct gpu_bounds
+{
+    /** Center of the box. */
+    glm::vec3     center;
+    /** Index of the command drawing the mesh of the instance. */
+    std::uint32_t mesh;
+    /** Half size of the box. */
+    glm::vec3     extent;
+    float         padding;
+};
+
+} /* namespace extension */
+
+template<>
+struct gl_buffer_type<extension::gpu_bounds>
+{
+    static constexpr GLenum target = GL_SHADER_STORAGE_BUFFER;
+    static constexpr GLenum usage  = GL_STATIC_DRAW;
+};
+
+namespace extension {
+
+/**
+ * @brief Buffer type of the visible instance ids, written by the GPU and read as an instanced attribute.
+ */
+struct gpu_visible_buffer
+{
+    static constexpr GLenum target = GL_ARRAY_BUFFER;
+    static constexpr GLenum usage  = GL_DYNAMIC_COPY;
+};
+
+namespace priv {
+
+/*
+ * Declarations shared by the compute shaders.
+ */
+inline std::string src_gpu_cull_common()
+{
+    return "#version 430\n"
+           "layout(local_size_x = 64) in;\n"
+           "struct draw_command { uint count; uint instance_count; uint first_index; int base_vertex; uint base_instance; };\n"
+           "layout(std430, binding = 1) buffer Commands { draw_command commands[]; };\n";
+}
+
+/*
+ * Reset the instance count of every command.
+ */
+inline std::string src_gpu_cull_reset_shader()
+{
+    return src_gpu_cull_common() +
+           "uniform int command_total;\n"
+           "void main(void){\n"
+           " uint i = gl_GlobalInvocationID.x;\n"
+           " if(i < uint(command_total))\n"
+           "  commands[i].instance_count = 0u;\n"
+           "}";
+}
+
+/*
+ * Test each instance against the frustum, and the Hi-Z pyramid when enabled,
+ * then append the visible ones to the range of their command.
+ */
+inline std::string src_gpu_cull_shader()
+{
+    return src_gpu_cull_common() +
+           "struct instance_bounds { vec3 center; uint mesh; vec3 extent; float padding; };\n"
+           "layout(std430, binding = 0) readonly buffer Bounds { instance_bounds bounds[]; };\n"
+           "layout(std430, binding = 2) writeonly buffer Visible { uint visible[]; };\n"
+           "uniform vec4 planes[6];\n"
+           "uniform int instance_total;\n"
+           "uniform bool use_hiz;\n"
+           "uniform sampler2D hiz;\n"
+           "uniform mat4 view_projection;\n"
+           "bool in_frustum(vec3 c, vec3 e){\n"
+           " for(int p = 0; p < 6; ++p)\n"
+           "  if(dot(planes[p].xyz, c) + dot(abs(planes[p].xyz), e) + planes[p].w < 0.0)\n"
+           "   return false;\n"
+           " return true;\n"
+           "}\n"
+           "bool occluded(vec3 c, vec3 e){\n"
+           " vec3 lo = vec3(1.0), hi = vec3(-1.0);\n"
+           " for(int i = 0; i < 8; ++i){\n"
+           "  vec3 corner = c + e * vec3((i & 1) != 0 ? 1.0 : -1.0, (i & 2) != 0 ? 1.0 : -1.0, (i & 4) != 0 ? 1.0 : -1.0);\n"
+           "  vec4 clip = view_projection * vec4(corner, 1.0);\n"
+           "  if(clip.w <= 0.0)\n"
+           "   return false;\n"
+           "  lo = min(lo, clip.xyz / clip.w);\n"
+           "  hi = max(hi, clip.xyz / clip.w);\n"
+           " }\n"
+           " vec2 a = clamp(lo.xy * 0.5 + 0.5, 0.0, 1.0), b = clamp(hi.xy * 0.5 + 0.5, 0.0, 1.0);\n"
+           " vec2 size = (b - a) * vec2(textureSize(hiz, 0));\n"
+           " float level = ceil(log2(max(max(size.x, size.y), 1.0)));\n"
+           " float depth = max(max(textureLod(hiz, a, level).r, textureLod(hiz, vec2(b.x, a.y), level).r),\n"
+           "                   max(textureLod(hiz, vec2(a.x, b.y), level).r, textureLod(hiz, b, level).r));\n"
+           " return lo.z * 0.5 + 0.5 > depth;\n"
+           "}\n"
+           "void main(void){\n"
+           " uint i = gl_GlobalInvocationID.x;\n"
+           " if(i >= uint(instance_total))\n"
+           "  return;\n"
+           " instance_bounds box = bounds[i];\n"
+           " if(!in_frustum(box.center, box.extent) || (use_hiz && occluded(box.center, box.extent)))\n"
+           "  return;\n"
+           " uint slot = atomicAdd(commands[box.mesh].instance_count, 1u);\n"
+           " visible[commands[box.mesh].base_instance + slot] = i;\n"
+           "}";
+}
+
+} /* namespace priv */
+
+/**
+ * @brief gpu_culler culls instances with a compute shader, filling the indirect commands on the GPU.
+ *
+ * Each instance has a gpu_bounds, which tells the command drawing its mesh. Every frame:
+ *  - the instance_count of the commands is reset;
+ *  - each instance is tested against the frustum and, optionally, a Hi-Z pyramid;
+ *  - the visible instances increment the instance_count of their command with an atomic add,
+ *    and write their index at base_instance + count in the visible ids.
+ *
+ * The base_instance of each command must thus start a range of the visible ids large enough for
+ * all the instances of its mesh. Bound as an instanced attribute, the visible ids give the vertex
+ * shader the index of the per instance data to fetch. Nothing goes through the CPU:
+ *  @code
+ *      mgl::extension::gpu_culler culler;
+ *      culler.cull(mgl::extension::frustum::from_matrix(proj * view), bounds, commands, visible);
+ *      mgl::gl_draw_indirect(vao, program, commands);
+ *  @endcode
+ * Requires OpenGL 4.3 or ARB_compute_shader and ARB_shader_storage_buffer_object.
+ */
+class gpu_culler
+{
+public:
+    /** Shader storage binding points used by the shaders. */
+    static constexpr GLuint bounds_binding   = 0;
+    static constexpr GLuint commands_binding = 1;
+    static constexpr GLuint visible_binding  = 2;
+    /** Number of invocations per work group. */
+    static constexpr GLuint group_size       = 64;
+
+    // ================================================================ //
+    // =========================== CTOR/DTOR ========================== //
+    // ================================================================ //
+
+    /**
+     * @brief Constructor, compile the compute shaders in the current context.
+     * @throw gl_exception_specific if compute shaders aren't available.
+     */
+    gpu_culler()
+        : m_reset()
+        , m_cull()
+    {
+        if(!mgl::priv::has_compute_shader())
+            throw gl_exception_specific("gpu_culler: ", "compute shaders aren't supported.");
+        m_reset = make_program(priv::src_gpu_cull_reset_shader());
+        m_cull  = make_program(priv::src_gpu_cull_shader());
+        m_command_total = m_reset.get_uniform("command_total");
+        for(int p = 0; p < 6; ++p)
+            m_planes[p] = m_cull.get_uniform(("planes[" + std::to_string(p) + "]").c_str());
+        m_instance_total  = m_cull.get_uniform("instance_total");
+        m_use_hiz         = m_cull.get_uniform("use_hiz");
+        m_hiz             = m_cull.get_uniform("hiz");
+        m_view_projection = m_cull.get_uniform("view_projection");
+    }
+
+    // ================================================================ //
+    // ============================ METHODS =========================== //
+    // ================================================================ //
+
+    /**
+     * @brief Cull the instances against the frustum.
+     * @param p_frustum is the frustum.
+     * @param p_bounds are the boxes of the instances, their mesh must be an index of p_commands
+     *        (checked in debug, which maps p_bounds at each call).
+     * @param p_commands are the commands, one per mesh. Only their instance_count is written.
+     * @param p_visible receives the visible instance ids, it must be as large as p_bounds.
+     */
+    template<typename B1, typename B2, typename B3>
+    void cull(const frustum& p_frustum, const gl_vector<gpu_bounds, B1>& p_bounds,
+              gl_vector<draw_elements_indirect_command, B2>& p_commands, gl_vector<std::uint32_t, B3>& p_visible) const
+    {
+        m_cull.use();
+        m_cull.set(m_use_hiz, 0);
+        run(p_frustum, p_bounds, p_commands, p_visible);
+    }
+
+    /**
+     * @brief Cull the instances against the frustum and a Hi-Z pyramid.
+     *
+     * Texel (x, y) of level n of the pyramid holds the farthest depth of the 2x2 texels under it
+     * at level n - 1, level 0 being the depth buffer of the previous frame, or of the occluders.
+     * The texture must sample with GL_NEAREST_MIPMAP_NEAREST, see gl_texture::create.
+     * @param p_hiz is the pyramid.
+     * @param p_view_projection is the matrix the pyramid has been rendered with.
+     * @param p_unit is the texture unit used.
+     */
+    template<typename B1, typename B2, typename B3>
+    void cull(const frustum& p_frustum, const gl_vector<gpu_bounds, B1>& p_bounds,
+              gl_vector<draw_elements_indirect_command, B2>& p_commands, gl_vector<std::uint32_t, B3>& p_visible,
+              const gl_texture_2D& p_hiz, const glm::mat4& p_view_projection, GLuint p_unit = 0) const
+    {
+        p_hiz.bind(p_unit);
+        m_cull.use();
+        m_cull.set(m_use_hiz, 1);
+        m_cull.set(m_hiz, static_cast<GLint>(p_unit));
+        m_cull.set(m_view_projection, p_view_projection);
+        run(p_frustum, p_bounds, p_commands, p_visible);
+    }
+
+private:
+
+    // ================================================================ //
+    // ============================ METHODS =========================== //
+    // ================================================================ //
+
+    static gl_program make_program(const std::string& p_src)
+    {
+        gl_shader shader(shader_type::COMPUTE_SHADER);
+        gl_program program;
+        // ------------------------- DECLARE ------------------------ //
+
+        shader.load_src(p_src);
+        program.attach(shader);
+        program.link();
+        return program;
+    }
+
+    static GLuint groups(std::size_t p_n)
+    {
+        return static_cast<GLuint>((p_n + group_size - 1) / group_size);
+    }
+
+    /*
+     * The cull program is in use, with the Hi-Z uniforms set.
+     */
+    template<typename B1, typename B2, typename B3>
+    void run(const frustum& p_frustum, const gl_vector<gpu_bounds, B1>& p_bounds,
+             gl_vector<draw_elements_indirect_command, B2>& p_commands, gl_vector<std::uint32_t, B3>& p_visible) const
+    {
+#       ifndef MGL_NDEBUG
+        assert(p_visible.size() >= p_bounds.size());
+#       endif
+        // ------------------------- DECLARE ------------------------ //
+
+        if(p_bounds.empty() || p_commands.empty())
+            return;
+#       ifndef MGL_NDEBUG
+        {
+            // The shader would add to a command past the end of p_commands.
+            gl_scope<gl_vector<gpu_bounds, B1>> mapped(p_bounds);
+            const gpu_bounds* boxes = p_bounds.data();
+            for(std::size_t i = 0; i < p_bounds.size(); ++i)
+                assert(boxes[i].mesh < p_commands.size());
+        }
+#       endif
+        for(int p = 0; p < 6; ++p)
+            m_cull.set(m_planes[p], p_frustum.planes[p]);
+        m_cull.set(m_instance_total, static_cast<GLint>(p_bounds.size()));
+        p_bounds.bind_base(GL_SHADER_STORAGE_BUFFER, bounds_binding);
+        p_commands.bind_base(GL_SHADER_STORAGE_BUFFER, commands_binding);
+        p_visible.bind_base(GL_SHADER_STORAGE_BUFFER, visible_binding);
+
+        m_reset.use();
+        m_reset.set(m_command_total, static_cast<GLint>(p_commands.size()));
+        m_reset.dispatch(groups(p_commands.size()));
+        gl_object_program::gl_memory_barrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+        m_cull.dispatch(groups(p_bounds.size()));
+        // The results are read as commands, attributes, storage buffers or mapped.
+        gl_object_program::gl_memory_barrier(GL_COMMAND_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT
+                                           | GL_SHADER_STORAGE_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+    }
+
+    // ================================================================ //
+    // ============================= FIELDS =========================== //
+    // ================================================================ //
+
+    /** Reset the instance counts of the commands. */
+    gl_program m_reset;
+    /** Cull the instances. */
+    gl_program m_cull;
+    /** Uniforms of the programs. */
+    gl_uniform m_command_total;
+    gl_uniform m_planes[6];
+    gl_uniform m_instance_total;
+    gl_uniform m_use_hiz;
+    gl_uniform m_hiz;
+    gl_uniform m_view_projection;
+};
+
+} /* namespace extension */
+} /* namespace mgl */
+
+#endif /* EXTENSION_GPU_CULLING_HPP_ */
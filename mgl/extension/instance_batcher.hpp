@@ -0,0 +1,302 @@
+/*
+ * instance_batcher.hpp
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: nemikolh
+ */
+
+#ifndef EXTENSION_INSTANCE_BATCHER_HPP_
+#define EXTENSION_INSTANCE_BATCHER_HPP_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <algorithm>
+#include <unordered_map>
+#include "../gldraw.hpp"
+#include "../glvector.hpp"
+#include "../type/glvao.hpp"
+#include "../type/glprogram.hpp"
+
+namespace mgl {
+namespace extension {
+
+/**
+ * @brief instance_batcher turns the repeated draws of a mesh with a program into one instanced draw.
+ *
+ * The draws are keyed by the program and the vertex and index buffers. For each key, the batcher
+ * owns a vao made of the mesh buffers plus one streaming gl_vector<Instance>, shared by all the keys
+ * and bound through make_instanced. The vao is created the first time the key is seen, and kept for
+ * the following frames. flush() uploads the instances of the whole frame at once, the instances of
+ * each key being contiguous, then draws each key with a single gl_draw_instanced starting at the
+ * base instance of its range, in the order the keys have first been seen during the frame.
+ *
+ * The buffers are identified by the state they share with their vaos (see gl_vector::track()),
+ * not by their address: a vector keeps its key when it grows or is moved, while a copy of it is
+ * another key. A batch holds this state and the program, so that the key can't be taken by
+ * another buffer while the batch lives. The batches are evicted by flush() once one of their
+ * buffers is destroyed, or when they haven't been drawn for the number of flushes passed to the
+ * constructor; a mesh drawn again later gets a new vao. The program must declare the attributes
+ * of Instance.
+ *
+ * The batching is opt-in: gl_draw keeps drawing immediately, and only the draws going through
+ * draw() are batched, thus the scene code has to call it instead of gl_draw, then flush() once
+ * the frame is recorded. A draw is also deferred until flush(), which the callers relying on the
+ * draw order with other gl_draw calls must take into account.
+ *  @code
+ *      MGL_DEFINE_GL_ATTRIBUTES(, transform, (glm::vec4, model_0)(glm::vec4, model_1)(glm::vec4, model_2)(glm::vec4, model_3))
+ *      mgl::extension::instance_batcher<transform> batcher;
+ *      for(auto& object : scene)
+ *          // was: mgl::gl_draw(object.vertices, object.indices, object.program);
+ *          batcher.draw(object.vertices, object.indices, object.program, object.transform);
+ *      batcher.flush();
+ *  @endcode
+ */
+template<typename Instance>
+class instance_batcher
+{
+    static_assert(mgl::priv::is_gl_attributes<Instance>::value, "Instance must be declared with MGL_DEFINE_GL_ATTRIBUTES.");
+
+public:
+    // ================================================================ //
+    // =========================== CTOR/DTOR ========================== //
+    // ================================================================ //
+
+    /**
+     * @brief Constructor.
+     * @param p_max_idle is the number of flushes a batch is kept without being drawn.
+     */
+    explicit instance_batcher(std::size_t p_max_idle = 60)
+        : m_batches()
+        , m_lookup()
+        , m_frame()
+        , m_stream()
+        , m_staging()
+        , m_max_idle(p_max_idle)
+        , m_flushes(0)
+        , m_draw_calls(0)
+        , m_instances(0)
+    {}
+
+    instance_batcher(const instance_batcher&) = delete;
+    instance_batcher& operator=(const instance_batcher&) = delete;
+
+    // ================================================================ //
+    // ============================ METHODS =========================== //
+    // ================================================================ //
+
+    /**
+     * @brief Record one instance of the mesh, drawn with p_program at the next flush.
+     * @param p_vertices is the vertex buffer of the mesh.
+     * @param p_indices is the index buffer of the mesh.
+     * @param p_program is the program.
+     * @param p_instance is the per instance data.
+     */
+    template<typename T, typename I>
+    void draw(const gl_vector<T>& p_vertices, const gl_vector<I>& p_indices,
+              const gl_program& p_program, const Instance& p_instance)
+    {
+        batch& b = find(p_vertices, p_indices, p_program);
+        // ------------------------- DECLARE ------------------------ //
+
+        if(b.pending.empty())
+        {
+            m_frame.push_back(&b);
+            b.last_flush = m_flushes + 1;
+        }
+        b.pending.push_back(p_instance);
+    }
+
+    /**
+     * @brief Draw the recorded instances, one instanced draw per mesh and program,
+     * then evict the batches of destroyed buffers and the idle ones.
+     */
+    void flush()
+    {
+        std::size_t first = 0;
+        // ------------------------- DECLARE ------------------------ //
+
+        // One upload for the whole frame.
+        m_staging.clear();
+        for(batch* b : m_frame)
+            m_staging.insert(m_staging.end(), b->pending.begin(), b->pending.end());
+        m_stream.assign(m_staging.begin(), m_staging.end());
+
+        for(batch* b : m_frame)
+        {
+            // The buffers of the mesh may have been destroyed since the draws were recorded.
+            if(b->alive())
+            {
+                b->program.use();
+                gl_draw_instanced(b->vao, b->pending.size(), first);
+                ++m_draw_calls;
+                m_instances += b->pending.size();
+            }
+            first += b->pending.size();
+            b->pending.clear();
+        }
+        m_frame.clear();
+        ++m_flushes;
+        evict();
+    }
+
+    /**
+     * @brief Drop the recorded instances and all the vaos.
+     */
+    void clear()
+    {
+        m_frame.clear();
+        m_lookup.clear();
+        m_batches.clear();
+    }
+
+    /**
+     * @brief Returns the number of meshes and programs pairs having a vao.
+     */
+    std::size_t size() const
+    {
+        return m_batches.size();
+    }
+
+    /**
+     * @brief Returns the number of draw calls issued by flush().
+     */
+    std::size_t draw_calls() const
+    {
+        return m_draw_calls;
+    }
+
+    /**
+     * @brief Returns the number of instances drawn by flush().
+     */
+    std::size_t instances() const
+    {
+        return m_instances;
+    }
+
+private:
+
+    struct key
+    {
+        const priv::gl_buffer_track*    vertices;
+        const priv::gl_buffer_track*    indices;
+        gl_types::uid                   program;
+
+        bool operator==(const key& p_rhs) const
+        {
+            return vertices == p_rhs.vertices && indices == p_rhs.indices && program == p_rhs.program;
+        }
+    };
+
+    struct key_hash
+    {
+        std::size_t operator()(const key& p_key) const
+        {
+            std::size_t h = std::hash<const void*>()(p_key.vertices);
+            h ^= std::hash<const void*>()(p_key.indices) + 0x9e3779b9 + (h << 6) + (h >> 2);
+            h ^= std::hash<gl_types::uid>()(p_key.program) + 0x9e3779b9 + (h << 6) + (h >> 2);
+            return h;
+        }
+    };
+
+    struct batch
+    {
+        /** The key of the batch. */
+        key                             id;
+        /** The state of the mesh buffers, kept alive so that the key stays unique. */
+        priv::gl_buffer_track_ptr       vertices;
+        priv::gl_buffer_track_ptr       indices;
+        /** The program, kept alive by reference counting. */
+        gl_program                      program;
+        /** The mesh buffers and the stream. */
+        gl_vao                          vao;
+        /** The instances recorded since the last flush. */
+        std::vector<Instance>           pending;
+        /** The number of flushes done once the batch has last been drawn. */
+        std::size_t                     last_flush;
+
+        /**
+         * @brief Returns true if the buffers of the mesh are still alive.
+         */
+        bool alive() const
+        {
+            return vertices->owner && indices->owner;
+        }
+    };
+
+    // ================================================================ //
+    // ============================ METHODS =========================== //
+    // ================================================================ //
+
+    template<typename T, typename I>
+    batch& find(const gl_vector<T>& p_vertices, const gl_vector<I>& p_indices, const gl_program& p_program)
+    {
+        priv::gl_buffer_track_ptr vertices = p_vertices.track();
+        priv::gl_buffer_track_ptr indices  = p_indices.track();
+        key k{vertices.get(), indices.get(), p_program.id()};
+        // ------------------------- DECLARE ------------------------ //
+
+        auto it = m_lookup.find(k);
+        if(it != m_lookup.end())
+            return *it->second;
+
+        std::unique_ptr<batch> b(new batch());
+        b->id       = k;
+        b->vertices = std::move(vertices);
+        b->indices  = std::move(indices);
+        b->program  = p_program;
+        // Allocate the stream, so that the vao starts with a valid buffer.
+        m_stream.reserve(64);
+        b->vao = p_program.make_vao(p_vertices, make_instanced(m_stream), p_indices);
+        batch& result = *b;
+        m_lookup.emplace(k, b.get());
+        m_batches.push_back(std::move(b));
+        return result;
+    }
+
+    /**
+     * Drop the batches whose buffers are destroyed, and the ones not drawn for m_max_idle flushes.
+     */
+    void evict()
+    {
+        auto expired = [this](const std::unique_ptr<batch>& p_batch)
+        {
+            return !p_batch->alive() || m_flushes - p_batch->last_flush > m_max_idle;
+        };
+        // ------------------------- DECLARE ------------------------ //
+
+        for(const std::unique_ptr<batch>& b : m_batches)
+        {
+            if(expired(b))
+                m_lookup.erase(b->id);
+        }
+        m_batches.erase(std::remove_if(m_batches.begin(), m_batches.end(), expired), m_batches.end());
+    }
+
+    // ================================================================ //
+    // ============================= FIELDS =========================== //
+    // ================================================================ //
+
+    /** All the batches, in creation order. */
+    std::vector<std::unique_ptr<batch>>         m_batches;
+    /** The batch of each key. */
+    std::unordered_map<key, batch*, key_hash>   m_lookup;
+    /** The batches having instances since the last flush, in first draw order. */
+    std::vector<batch*>                         m_frame;
+    /** The instances of all the batches, referenced by the vaos: the batcher must not move. */
+    gl_vector<Instance>                         m_stream;
+    /** The instances of the frame, gathered before the upload. */
+    std::vector<Instance>                       m_staging;
+    /** The number of flushes a batch is kept without being drawn. */
+    std::size_t                                 m_max_idle;
+    /** The number of flushes so far. */
+    std::size_t                                 m_flushes;
+    /** Statistics. */
+    std::size_t                                 m_draw_calls;
+    std::size_t                                 m_instances;
+};
+
+} /* namespace extension */
+} /* namespace mgl */
+
+#endif /* EXTENSION_INSTANCE_BATCHER_HPP_ */
@@ -0,0 +1,302 @@
+/*
+ * mesh_file.hpp
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: nemikolh
+ */
+
+#ifndef EXTENSION_MESH_FILE_HPP_
+#define EXTENSION_MESH_FILE_HPP_
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iterator>
+#include <algorithm>
+#include "../glvector.hpp"
+#include "../glexceptions.hpp"
+#include "../meta/gllayout.hpp"
+
+namespace mgl {
+namespace extension {
+
+/**
+ * @brief Header of a mesh file.
+ *
+ * A mesh file is made of:
+ *  - this header (64 bytes),
+ *  - one mesh_file_attribute per member of the attributes structure (64 bytes each),
+ *  - the raw content of the gl_vector, starting at data_offset.
+ *
+ * Every section starts on a 64 bytes boundary, thus a loader can mmap the file
+ * and give the data section directly to read_mesh() without any parsing of the vertices.
+ * Values are stored with the endianness of the host which wrote the file.
+ */
+struct mesh_file_header
+{
+    char            magic[4];
+    std::uint32_t   version;
+    std::uint64_t   element_count;
+    std::uint32_t   stride;
+    std::uint32_t   attribute_count;
+    std::uint64_t   layout_hash;
+    std::uint64_t   data_offset;
+    std::uint64_t   data_size;
+    std::uint8_t    reserved[16];
+};
+
+/**
+ * @brief Description of one attribute stored in a mesh file.
+ */
+struct mesh_file_attribute
+{
+    char            name[48];
+    std::uint32_t   offset;
+    std::uint32_t   components;
+    std::uint32_t   gl_type;
+    std::uint32_t   reserved;
+};
+
+static_assert(sizeof(mesh_file_header) == 64, "mesh_file_header must be 64 bytes long.");
+static_assert(sizeof(mesh_file_attribute) == 64, "mesh_file_attribute must be 64 bytes long.");
+
+namespace priv {
+
+/** Alignment of every section of a mesh file. */
+constexpr std::size_t mesh_file_alignment = 64;
+/** Current version of the format. */
+constexpr std::uint32_t mesh_file_version = 1;
+
+inline std::size_t gl_type_size(std::uint32_t p_type)
+{
+    switch(p_type)
+    {
+        case GL_BYTE:
+        case GL_UNSIGNED_BYTE:
+            return 1;
+        case GL_SHORT:
+        case GL_UNSIGNED_SHORT:
+            return 2;
+        case GL_DOUBLE:
+            return 8;
+        default:
+            return 4;
+    }
+}
+
+/**
+ * @brief Layout of the attributes structure T as stored in the files, computed once.
+ * The hash is the one of gl_vertex_layout, known at compile time.
+ */
+template<typename T>
+struct mesh_layout
+{
+    static const mesh_layout& get()
+    {
+        static const mesh_layout layout;
+        return layout;
+    }
+
+    std::vector<mesh_file_attribute> attributes;
+    std::uint64_t                    hash;
+
+private:
+    mesh_layout()
+        : attributes()
+        , hash(gl_vertex_layout<T>::hash)
+    {
+        for(const gl_attribute_desc& desc : gl_vertex_layout<T>::attributes)
+        {
+            mesh_file_attribute a{};
+            if(std::strlen(desc.name) >= sizeof(a.name))
+                throw gl_mesh_file_error(std::string("attribute name too long: ") + desc.name);
+            std::strncpy(a.name, desc.name, sizeof(a.name));
+            a.offset     = desc.offset;
+            a.components = desc.components * desc.columns;
+            a.gl_type    = desc.gl_type;
+            attributes.push_back(a);
+        }
+    }
+};
+
+/**
+ * @brief Copy one attribute of Size bytes for all the elements.
+ * Having Size known at compile time lets the compiler vectorize the loop.
+ */
+template<std::size_t Size>
+void copy_strided(char* p_dst, std::size_t p_dst_stride, const char* p_src, std::size_t p_src_stride, std::size_t p_count)
+{
+    for(std::size_t i = 0; i < p_count; ++i)
+        std::memcpy(p_dst + i * p_dst_stride, p_src + i * p_src_stride, Size);
+}
+
+inline void copy_strided(char* p_dst, std::size_t p_dst_stride, const char* p_src, std::size_t p_src_stride,
+                         std::size_t p_count, std::size_t p_size)
+{
+    switch(p_size)
+    {
+        case 4:  copy_strided<4>(p_dst, p_dst_stride, p_src, p_src_stride, p_count);  break;
+        case 8:  copy_strided<8>(p_dst, p_dst_stride, p_src, p_src_stride, p_count);  break;
+        case 12: copy_strided<12>(p_dst, p_dst_stride, p_src, p_src_stride, p_count); break;
+        case 16: copy_strided<16>(p_dst, p_dst_stride, p_src, p_src_stride, p_count); break;
+        default:
+            for(std::size_t i = 0; i < p_count; ++i)
+                std::memcpy(p_dst + i * p_dst_stride, p_src + i * p_src_stride, p_size);
+    }
+}
+
+/**
+ * @brief Repack the data of a file whose layout differs from T.
+ * Attributes are matched by name, attributes missing from the file are value-initialized.
+ */
+template<typename T>
+void repack(const mesh_file_header& p_header, const mesh_file_attribute* p_file_attributes,
+            const char* p_src, T* p_dst)
+{
+    const mesh_layout<T>& layout = mesh_layout<T>::get();
+    for(const mesh_file_attribute& a : layout.attributes)
+    {
+        for(std::uint32_t i = 0; i < p_header.attribute_count; ++i)
+        {
+            const mesh_file_attribute& f = p_file_attributes[i];
+            if(std::strncmp(a.name, f.name, sizeof(a.name)) != 0)
+                continue;
+            std::size_t size = a.components * gl_type_size(a.gl_type);
+            if(a.components != f.components || a.gl_type != f.gl_type)
+                throw gl_mesh_file_error(std::string("type mismatch for attribute ") + a.name);
+            if(f.offset + size > p_header.stride)
+                throw gl_mesh_file_error(std::string("attribute outside of the stride: ") + a.name);
+            copy_strided(reinterpret_cast<char*>(p_dst) + a.offset, sizeof(T),
+                         p_src + f.offset, p_header.stride,
+                         p_header.element_count, size);
+            break;
+        }
+    }
+}
+
+}  /* namespace priv */
+
+/**
+ * @brief Read a mesh file already loaded (or mmaped) in memory into p_out.
+ *
+ * When the layout stored in the file matches T, which is checked by comparing
+ * the layout hashes, the data section is uploaded as is. Otherwise the attributes
+ * are matched by name and repacked into T before the upload.
+ * @param p_data is the content of the file.
+ * @param p_size is the size in bytes of p_data.
+ * @param p_out is the vector receiving the data.
+ */
+template<typename T, typename B>
+void read_mesh(const void* p_data, std::size_t p_size, gl_vector<T, B>& p_out)
+{
+    static_assert(mgl::priv::is_gl_attributes<T>::value, "T must be declared with MGL_DEFINE_GL_ATTRIBUTES.");
+    const char* bytes = static_cast<const char*>(p_data);
+    mesh_file_header header;
+    // ------------------------- DECLARE ------------------------ //
+
+    if(p_size < sizeof(header))
+        throw gl_mesh_file_error("truncated header");
+    std::memcpy(&header, bytes, sizeof(header));
+
+    if(std::memcmp(header.magic, "MGLM", 4) != 0)
+        throw gl_mesh_file_error("bad magic number");
+    if(header.version != priv::mesh_file_version)
+        throw gl_mesh_file_error("unsupported version");
+    // The sizes come from the file, they are checked without any product or sum which could overflow.
+    if(header.stride == 0
+       || header.data_offset % priv::mesh_file_alignment != 0
+       || header.data_offset > p_size
+       || header.data_offset < sizeof(header) + header.attribute_count * sizeof(mesh_file_attribute)
+       || header.element_count > (p_size - header.data_offset) / header.stride
+       || header.data_size != header.element_count * header.stride)
+        throw gl_mesh_file_error("inconsistent sizes");
+
+    const char* src = bytes + header.data_offset;
+    const priv::mesh_layout<T>& layout = priv::mesh_layout<T>::get();
+
+    if(header.layout_hash == layout.hash
+       && header.stride == sizeof(T)
+       && reinterpret_cast<std::uintptr_t>(src) % alignof(T) == 0)
+    {
+        // Same layout: straight upload.
+        p_out.clear();
+        p_out.append(reinterpret_cast<const T*>(src), header.element_count);
+    }
+    else
+    {
+        std::vector<mesh_file_attribute> attributes(header.attribute_count);
+        std::memcpy(attributes.data(), bytes + sizeof(header), attributes.size() * sizeof(mesh_file_attribute));
+        std::vector<T> repacked(header.element_count);
+        priv::repack(header, attributes.data(), src, repacked.data());
+        p_out.clear();
+        p_out.append(repacked.data(), repacked.size());
+    }
+}
+
+/**
+ * @brief Write the content of p_vector in the mesh file format.
+ * @param p_os is the output stream, it must have been opened in binary mode.
+ * @param p_vector is the vector to write.
+ */
+template<typename T, typename B>
+void write_mesh(std::ostream& p_os, const gl_vector<T, B>& p_vector)
+{
+    static_assert(mgl::priv::is_gl_attributes<T>::value, "T must be declared with MGL_DEFINE_GL_ATTRIBUTES.");
+    const priv::mesh_layout<T>& layout = priv::mesh_layout<T>::get();
+    mesh_file_header header{};
+    // ------------------------- DECLARE ------------------------ //
+
+    std::memcpy(header.magic, "MGLM", 4);
+    header.version         = priv::mesh_file_version;
+    header.element_count   = p_vector.size();
+    header.stride          = sizeof(T);
+    header.attribute_count = layout.attributes.size();
+    header.layout_hash     = layout.hash;
+    header.data_offset     = sizeof(header) + layout.attributes.size() * sizeof(mesh_file_attribute);
+    header.data_size       = p_vector.size() * sizeof(T);
+
+    p_os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    p_os.write(reinterpret_cast<const char*>(layout.attributes.data()),
+               layout.attributes.size() * sizeof(mesh_file_attribute));
+    if(!p_vector.empty())
+    {
+        gl_scope<gl_vector<T, B>> lock(p_vector);
+        p_os.write(reinterpret_cast<const char*>(p_vector.data()), header.data_size);
+    }
+}
+
+/**
+ * @brief Load a mesh file into p_out.
+ * @param p_path is the path of the file.
+ * @param p_out is the vector receiving the data.
+ */
+template<typename T, typename B>
+void load_mesh_file(const std::string& p_path, gl_vector<T, B>& p_out)
+{
+    std::ifstream file(p_path, std::ios::binary);
+    if(!file)
+        throw gl_mesh_file_error("can't open " + p_path);
+    std::vector<char> content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    read_mesh(content.data(), content.size(), p_out);
+}
+
+/**
+ * @brief Save p_vector into a mesh file.
+ * @param p_path is the path of the file.
+ * @param p_vector is the vector to save.
+ */
+template<typename T, typename B>
+void save_mesh_file(const std::string& p_path, const gl_vector<T, B>& p_vector)
+{
+    std::ofstream file(p_path, std::ios::binary);
+    if(!file)
+        throw gl_mesh_file_error("can't open " + p_path);
+    write_mesh(file, p_vector);
+}
+
+}  /* namespace extension */
+}  /* namespace mgl */
+
+#endif /* EXTENSION_MESH_FILE_HPP_ */
@@ -0,0 +1,120 @@
+/*
+ * cull_kernel.hpp
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: nemikolh
+ */
+
+#ifndef EXTENSION_PRIV_CULL_KERNEL_HPP_
+#define EXTENSION_PRIV_CULL_KERNEL_HPP_
+
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+
+#if defined(__AVX2__) && !defined(MGL_NO_SIMD)
+#   define MGL_CULL_AVX2
+#   include <immintrin.h>
+#endif
+
+namespace mgl {
+namespace extension {
+namespace priv {
+
+/**
+ * @brief Boxes stored as structure of arrays: one array per coordinate of the centers and of the half extents.
+ */
+struct cull_boxes
+{
+    const float* cx;
+    const float* cy;
+    const float* cz;
+    const float* ex;
+    const float* ey;
+    const float* ez;
+};
+
+/**
+ * @brief Returns true when the box is at least partly on the positive side of the 6 planes.
+ *
+ * The distances are summed in the order of the AVX2 path, and a NaN distance culls the box
+ * in both paths.
+ * @param p_planes are the planes, (a, b, c, d) each, normals pointing inside.
+ */
+inline bool cull_box_visible(const float* p_planes, const cull_boxes& p_boxes, std::size_t p_i)
+{
+    for(std::size_t p = 0; p < 6; ++p)
+    {
+        const float* plane = p_planes + 4 * p;
+        float d = plane[3] + plane[0] * p_boxes.cx[p_i] + plane[1] * p_boxes.cy[p_i] + plane[2] * p_boxes.cz[p_i]
+                + std::fabs(plane[0]) * p_boxes.ex[p_i] + std::fabs(plane[1]) * p_boxes.ey[p_i]
+                + std::fabs(plane[2]) * p_boxes.ez[p_i];
+        if(!(d >= 0.f))
+            return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Test the boxes [p_first, p_last[ against the planes, and call p_visible(i) for each visible box, in order.
+ *
+ * When compiled with AVX2 (and without MGL_NO_SIMD), the boxes are tested 8 by 8.
+ * @param p_planes are the 6 planes, (a, b, c, d) each, normals pointing inside.
+ * @param p_boxes are the boxes.
+ * @param p_visible is called with the index of every visible box.
+ */
+template<typename Func>
+void cull_boxes_range(const float* p_planes, const cull_boxes& p_boxes,
+                      std::size_t p_first, std::size_t p_last, Func&& p_visible)
+{
+    std::size_t i = p_first;
+    // ------------------------- DECLARE ------------------------ //
+
+#ifdef MGL_CULL_AVX2
+    const __m256 zero = _mm256_setzero_ps();
+    __m256 n[6][3], abs_n[6][3], w[6];
+    for(std::size_t p = 0; p < 6; ++p)
+    {
+        for(std::size_t c = 0; c < 3; ++c)
+        {
+            n[p][c]     = _mm256_set1_ps(p_planes[4 * p + c]);
+            abs_n[p][c] = _mm256_set1_ps(std::fabs(p_planes[4 * p + c]));
+        }
+        w[p] = _mm256_set1_ps(p_planes[4 * p + 3]);
+    }
+
+    for(; i + 8 <= p_last; i += 8)
+    {
+        const __m256 cx = _mm256_loadu_ps(p_boxes.cx + i);
+        const __m256 cy = _mm256_loadu_ps(p_boxes.cy + i);
+        const __m256 cz = _mm256_loadu_ps(p_boxes.cz + i);
+        const __m256 ex = _mm256_loadu_ps(p_boxes.ex + i);
+        const __m256 ey = _mm256_loadu_ps(p_boxes.ey + i);
+        const __m256 ez = _mm256_loadu_ps(p_boxes.ez + i);
+        int mask = 0xFF;
+        for(std::size_t p = 0; p < 6 && mask; ++p)
+        {
+            __m256 d = _mm256_add_ps(w[p], _mm256_mul_ps(n[p][0], cx));
+            d = _mm256_add_ps(d, _mm256_mul_ps(n[p][1], cy));
+            d = _mm256_add_ps(d, _mm256_mul_ps(n[p][2], cz));
+            d = _mm256_add_ps(d, _mm256_mul_ps(abs_n[p][0], ex));
+            d = _mm256_add_ps(d, _mm256_mul_ps(abs_n[p][1], ey));
+            d = _mm256_add_ps(d, _mm256_mul_ps(abs_n[p][2], ez));
+            mask &= _mm256_movemask_ps(_mm256_cmp_ps(d, zero, _CMP_GE_OQ));
+        }
+        for(std::size_t bit = 0; mask; ++bit, mask >>= 1)
+            if(mask & 1)
+                p_visible(i + bit);
+    }
+#endif
+
+    for(; i < p_last; ++i)
+        if(cull_box_visible(p_planes, p_boxes, i))
+            p_visible(i);
+}
+
+} /* namespace priv */
+} /* namespace extension */
+} /* namespace mgl */
+
+#endif /* EXTENSION_PRIV_CULL_KERNEL_HPP_ */
@@ -9,7 +9,11 @@
 #define EXTENSION_PRIV_DETAILS_GEN_HEADER_HPP_
 
 #include <string>
+#include <functional>
 #include "../../shader/glsltranslator.hpp"
+#include "../../meta/gltuplesize.hpp"
+#include "../../meta/glmhelper.hpp"
+#include "../../glrequires.hpp"
 
 namespace mgl {
 namespace extension {
@@ -22,8 +26,21 @@ struct gen_header
         , m_qualifier()
         , m_prefix(" ")
         , m_is_entry_acceptable([](std::size_t){ return true; })
+        , m_explicit_location(false)
+        , m_location(0)
     {}
 
+    /**
+     * @brief Emit layout(location = N) in front of each entry, N being the
+     * location assigned at compile time to the attribute.
+     * @param p_first_location is the location of the first entry, see attribute_location_base.
+     */
+    void set_explicit_location(unsigned int p_first_location)
+    {
+        m_explicit_location = true;
+        m_location = p_first_location;
+    }
+
     void set_qualifier(const char* p_qualifier)
     {
         m_qualifier = p_qualifier;
@@ -44,8 +61,13 @@ struct gen_header
     template<typename E, std::size_t N>
     void apply(const char* str)
     {
+        // A matrix takes one location per column, a dvec3 or dvec4 two unless it is converted to float.
+        unsigned int location = m_location;
+        m_location += mgl::priv::has_vertex_attrib_64bit() ? attribute_slots<E>::value : attribute_columns<E>::value;
         if(m_is_entry_acceptable(N))
         {
+            if(m_explicit_location)
+                content += "layout(location = " + std::to_string(location) + ") ";
             content += m_qualifier + " ";
             content += glsl_translator<E>::type_str();
             content += m_prefix;
@@ -59,6 +81,8 @@ private:
     std::string m_qualifier;
     std::string m_prefix;
     std::function<bool(std::size_t)> m_is_entry_acceptable;
+    bool         m_explicit_location;
+    unsigned int m_location;
 };
 
 }  /* namespace priv */
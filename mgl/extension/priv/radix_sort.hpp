@@ -0,0 +1,113 @@
+/*
+ * radix_sort.hpp
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: nemikolh
+ */
+
+#ifndef EXTENSION_PRIV_RADIX_SORT_HPP_
+#define EXTENSION_PRIV_RADIX_SORT_HPP_
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include "worker_pool.hpp"
+
+namespace mgl {
+namespace extension {
+namespace priv {
+
+/**
+ * @brief Element sorted by radix_sort: a 64-bit key and the index of what it refers to.
+ */
+struct sort_item
+{
+    std::uint64_t key;
+    std::uint32_t index;
+};
+
+/**
+ * @brief Sort p_items by key with a LSD radix sort, 8 bits per pass.
+ *
+ * The sort is stable. Each pass is split between the threads of p_pool: every thread builds the
+ * histogram of its chunk, then scatters its chunk at offsets computed from all the histograms.
+ * Arrays smaller than two chunks are sorted by the calling thread alone. The passes where
+ * every key has the same digit are skipped.
+ * @param p_items is the array to sort.
+ * @param p_tmp is a buffer of the same size, used between passes.
+ * @param p_pool runs the chunks, its size bounds the number of threads used.
+ */
+inline void radix_sort(std::vector<sort_item>& p_items, std::vector<sort_item>& p_tmp, worker_pool& p_pool)
+{
+    constexpr std::size_t radix = 256;
+    // Below this size per thread, the threads cost more than they save.
+    constexpr std::size_t min_chunk = 1 << 14;
+    const std::size_t n = p_items.size();
+    const std::size_t threads = std::max<std::size_t>(1, std::min<std::size_t>(p_pool.size(), n / min_chunk));
+    const std::size_t chunk = (n + threads - 1) / threads;
+    std::vector<std::size_t> histograms(threads * radix);
+    sort_item* src = p_items.data();
+    sort_item* dst = nullptr;
+    // ------------------------- DECLARE ------------------------ //
+
+    if(n < 2)
+        return;
+    p_tmp.resize(n);
+    dst = p_tmp.data();
+
+    // Runs p_f(t, first, last) for each chunk t.
+    auto parallel = [&](const std::function<void(std::size_t, std::size_t, std::size_t)>& p_f)
+    {
+        p_pool.run(threads, [&](std::size_t t) { p_f(t, std::min(n, t * chunk), std::min(n, (t + 1) * chunk)); });
+    };
+
+    for(unsigned int shift = 0; shift < 64; shift += 8)
+    {
+        std::fill(histograms.begin(), histograms.end(), 0);
+        parallel([&](std::size_t t, std::size_t first, std::size_t last)
+        {
+            std::size_t* h = &histograms[t * radix];
+            for(std::size_t i = first; i < last; ++i)
+                ++h[(src[i].key >> shift) & 0xFF];
+        });
+
+        // Skip the pass when all the keys share this digit.
+        std::size_t digit = (src[0].key >> shift) & 0xFF;
+        std::size_t count = 0;
+        for(std::size_t t = 0; t < threads; ++t)
+            count += histograms[t * radix + digit];
+        if(count == n)
+            continue;
+
+        // Turn the histograms into offsets: digit major, thread minor, to keep the sort stable.
+        std::size_t offset = 0;
+        for(std::size_t d = 0; d < radix; ++d)
+        {
+            for(std::size_t t = 0; t < threads; ++t)
+            {
+                std::size_t c = histograms[t * radix + d];
+                histograms[t * radix + d] = offset;
+                offset += c;
+            }
+        }
+
+        parallel([&](std::size_t t, std::size_t first, std::size_t last)
+        {
+            std::size_t* h = &histograms[t * radix];
+            for(std::size_t i = first; i < last; ++i)
+                dst[h[(src[i].key >> shift) & 0xFF]++] = src[i];
+        });
+        std::swap(src, dst);
+    }
+
+    if(src != p_items.data())
+        p_items.swap(p_tmp);
+}
+
+} /* namespace priv */
+} /* namespace extension */
+} /* namespace mgl */
+
+#endif /* EXTENSION_PRIV_RADIX_SORT_HPP_ */
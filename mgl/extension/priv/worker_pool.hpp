@@ -0,0 +1,176 @@
+/*
+ * worker_pool.hpp
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: nemikolh
+ */
+
+#ifndef EXTENSION_PRIV_WORKER_POOL_HPP_
+#define EXTENSION_PRIV_WORKER_POOL_HPP_
+
+#include <cstddef>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cassert>
+
+namespace mgl {
+namespace extension {
+namespace priv {
+
+/**
+ * @brief worker_pool runs the tasks of a parallel loop on threads kept between the loops.
+ *
+ * The calling thread runs the task 0 and the workers the others, run() returns once they are
+ * all done. The workers are started by the first run() needing them, a pool only used for
+ * small inputs never starts any thread.
+ */
+class worker_pool
+{
+public:
+    // ================================================================ //
+    // =========================== CTOR/DTOR ========================== //
+    // ================================================================ //
+
+    /**
+     * @brief Constructor.
+     * @param p_threads is the maximum number of tasks run at once, the calling thread included.
+     */
+    explicit worker_pool(unsigned int p_threads)
+        : m_size(p_threads ? p_threads : 1)
+        , m_workers()
+        , m_mutex()
+        , m_start()
+        , m_done()
+        , m_round(0)
+        , m_tasks(0)
+        , m_pending(0)
+        , m_call(nullptr)
+        , m_context(nullptr)
+        , m_stop(false)
+    {}
+
+    worker_pool(const worker_pool&) = delete;
+    worker_pool& operator=(const worker_pool&) = delete;
+
+    ~worker_pool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_start.notify_all();
+        for(std::thread& worker : m_workers)
+            worker.join();
+    }
+
+    // ================================================================ //
+    // ============================ METHODS =========================== //
+    // ================================================================ //
+
+    /**
+     * @brief Returns the maximum number of tasks run at once.
+     */
+    unsigned int size() const
+    {
+        return m_size;
+    }
+
+    /**
+     * @brief Run p_f(t) for each task t in [0, p_tasks), and wait for all of them.
+     * @param p_tasks is the number of tasks, at most size().
+     * @param p_f is the task, called from several threads at once.
+     */
+    template<typename F>
+    void run(std::size_t p_tasks, const F& p_f)
+    {
+#       ifndef MGL_NDEBUG
+        assert(p_tasks <= m_size);
+#       endif
+        if(p_tasks < 2)
+        {
+            if(p_tasks)
+                p_f(0);
+            return;
+        }
+        while(m_workers.size() + 1 < p_tasks)
+            m_workers.emplace_back(&worker_pool::work, this, m_workers.size() + 1, m_round);
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_call    = [](const void* p_context, std::size_t p_task) { (*static_cast<const F*>(p_context))(p_task); };
+            m_context = &p_f;
+            m_tasks   = p_tasks;
+            m_pending = p_tasks - 1;
+            ++m_round;
+        }
+        m_start.notify_all();
+        p_f(0);
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_done.wait(lock, [this]() { return m_pending == 0; });
+    }
+
+private:
+    // ================================================================ //
+    // ============================ METHODS =========================== //
+    // ================================================================ //
+
+    /**
+     * @brief The loop of a worker.
+     * @param p_task is the task the worker runs in each loop.
+     * @param p_round is the last loop started when the worker was created.
+     */
+    void work(std::size_t p_task, std::size_t p_round)
+    {
+        std::size_t round = p_round;
+        // ------------------------- DECLARE ------------------------ //
+
+        for(;;)
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_start.wait(lock, [&]() { return m_stop || m_round != round; });
+            if(m_stop)
+                return;
+            round = m_round;
+            if(p_task >= m_tasks)
+                continue;
+            lock.unlock();
+            m_call(m_context, p_task);
+            lock.lock();
+            if(--m_pending == 0)
+                m_done.notify_one();
+        }
+    }
+
+    // ================================================================ //
+    // ============================= FIELDS =========================== //
+    // ================================================================ //
+
+    /** The maximum number of tasks run at once. */
+    unsigned int                m_size;
+    /** The threads started, running the tasks 1 and following. */
+    std::vector<std::thread>    m_workers;
+    std::mutex                  m_mutex;
+    /** Signaled when a loop starts. */
+    std::condition_variable     m_start;
+    /** Signaled when the last task of a loop is done. */
+    std::condition_variable     m_done;
+    /** Incremented at each loop. */
+    std::size_t                 m_round;
+    /** The number of tasks of the current loop. */
+    std::size_t                 m_tasks;
+    /** The number of tasks of the workers not done yet. */
+    std::size_t                 m_pending;
+    /** Calls the task of the current loop. */
+    void                      (*m_call)(const void*, std::size_t);
+    /** The task of the current loop. */
+    const void*                 m_context;
+    /** True when the workers must exit. */
+    bool                        m_stop;
+};
+
+} /* namespace priv */
+} /* namespace extension */
+} /* namespace mgl */
+
+#endif /* EXTENSION_PRIV_WORKER_POOL_HPP_ */
@@ -0,0 +1,281 @@
+/*
+ * render_queue.hpp
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: nemikolh
+ */
+
+#ifndef EXTENSION_RENDER_QUEUE_HPP_
+#define EXTENSION_RENDER_QUEUE_HPP_
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <thread>
+#include <functional>
+#include "../gldraw.hpp"
+#include "../type/glvao.hpp"
+#include "../type/glprogram.hpp"
+#include "../type/gltexture.hpp"
+#include "priv/radix_sort.hpp"
+
+namespace mgl {
+namespace extension {
+
+/**
+ * @brief A draw recorded by the render_queue.
+ *
+ * The program, the vao and the textures must outlive the flush of the queue.
+ */
+struct draw_packet
+{
+    /** Maximum number of textures per packet. */
+    static constexpr std::size_t max_textures = 4;
+
+    struct texture_binding
+    {
+        GLenum        target;
+        gl_types::uid id;
+    };
+
+    // ================================================================ //
+    // =========================== CTOR/DTOR ========================== //
+    // ================================================================ //
+
+    /**
+     * @brief Constructor.
+     * @param p_program is the program to draw with.
+     * @param p_vao is the vao to draw.
+     * @param p_depth is the distance to the camera, used to order the packets of a same state.
+     */
+    draw_packet(const gl_program& p_program, const gl_vao& p_vao, float p_depth = 0.f)
+        : program(&p_program)
+        , vao(&p_vao)
+        , textures()
+        , uniforms()
+        , depth(p_depth)
+        , instance_count(0)
+    {}
+
+    // ================================================================ //
+    // ============================ METHODS =========================== //
+    // ================================================================ //
+
+    /**
+     * @brief Bind p_texture to the unit p_unit when drawing the packet.
+     */
+    template<typename Kind>
+    draw_packet& with_texture(std::size_t p_unit, const gl_texture<Kind>& p_texture)
+    {
+#       ifndef MGL_NDEBUG
+        assert(p_unit < max_textures);
+#       endif
+        textures[p_unit] = texture_binding{Kind::target, p_texture.id()};
+        return *this;
+    }
+
+    /**
+     * @brief Set the uniforms of the packet, called once the program is in use.
+     */
+    draw_packet& with_uniforms(std::function<void(const gl_program&)> p_uniforms)
+    {
+        uniforms = std::move(p_uniforms);
+        return *this;
+    }
+
+    // ================================================================ //
+    // ============================= FIELDS =========================== //
+    // ================================================================ //
+
+    /** The program. */
+    const gl_program*                       program;
+    /** The vao. */
+    const gl_vao*                           vao;
+    /** The textures per unit, an id of 0 means no texture. */
+    texture_binding                         textures[max_textures];
+    /** Set the uniforms of the packet, can be empty. */
+    std::function<void(const gl_program&)>  uniforms;
+    /** The distance to the camera. */
+    float                                   depth;
+    /** The number of instances, 0 for a non instanced draw. */
+    std::size_t                             instance_count;
+};
+
+/**
+ * @brief render_queue collects draw packets, then replays them sorted by state.
+ *
+ * Each packet gets a 64-bit key when pushed:
+ *  - opaque packets:      bucket(1) | program(12) | vao(16) | texture(11) | depth(24),
+ *    so that state changes are minimized and packets of a same state are drawn front to back;
+ *  - transparent packets: bucket(1) | inverted depth(24) | program(12) | vao(16) | texture(11),
+ *    drawn back to front after all the opaque packets.
+ *
+ * The ids are truncated to their low bits: two objects sharing these bits only lose some
+ * batching. The keys are sorted with a parallel radix sort, and the packets are drawn through
+ * the usual path, where a gl_state_cache made current drops the binds that don't change anything.
+ *  @code
+ *      mgl::extension::render_queue queue;
+ *      for(auto& object : scene)
+ *          queue.push(mgl::extension::draw_packet(object.program, object.vao, object.depth)
+ *                          .with_texture(0, object.diffuse),
+ *                     object.transparent ? render_queue::bucket::transparent : render_queue::bucket::opaque);
+ *      queue.flush();
+ *  @endcode
+ */
+class render_queue
+{
+public:
+    enum class bucket { opaque, transparent };
+
+    // ================================================================ //
+    // =========================== CTOR/DTOR ========================== //
+    // ================================================================ //
+
+    /**
+     * @brief Constructor.
+     * @param p_threads is the number of threads used to sort, all the cores by default.
+     */
+    explicit render_queue(unsigned int p_threads = std::thread::hardware_concurrency())
+        : m_packets()
+        , m_items()
+        , m_tmp()
+        , m_pool(p_threads)
+    {}
+
+    // ================================================================ //
+    // ============================ METHODS =========================== //
+    // ================================================================ //
+
+    /**
+     * @brief Add a packet to the queue.
+     * @param p_packet is the packet.
+     * @param p_bucket tells whether the packet is opaque or transparent.
+     */
+    void push(draw_packet p_packet, bucket p_bucket = bucket::opaque)
+    {
+        m_items.push_back(priv::sort_item{make_key(p_packet, p_bucket), static_cast<std::uint32_t>(m_packets.size())});
+        m_packets.push_back(std::move(p_packet));
+    }
+
+    /**
+     * @brief Sort the packets by key.
+     */
+    void sort()
+    {
+        priv::radix_sort(m_items, m_tmp, m_pool);
+    }
+
+    /**
+     * @brief Sort and draw the packets, then empty the queue.
+     *
+     * A unit without texture in a packet is unbound if the previous packet had one there.
+     */
+    void flush()
+    {
+        draw_packet::texture_binding bound[draw_packet::max_textures] = {};
+        // ------------------------- DECLARE ------------------------ //
+
+        sort();
+        for(const priv::sort_item& item : m_items)
+            draw(m_packets[item.index], bound);
+        clear();
+    }
+
+    /**
+     * @brief Empty the queue, keeping its memory.
+     */
+    void clear()
+    {
+        m_packets.clear();
+        m_items.clear();
+    }
+
+    /**
+     * @brief Returns the number of packets in the queue.
+     */
+    std::size_t size() const
+    {
+        return m_packets.size();
+    }
+
+    /**
+     * @brief Returns the key of the passed packet.
+     */
+    static std::uint64_t make_key(const draw_packet& p_packet, bucket p_bucket)
+    {
+        std::uint64_t program = p_packet.program->id() & 0xFFF;
+        std::uint64_t vao     = p_packet.vao->id() & 0xFFFF;
+        std::uint64_t texture = p_packet.textures[0].id & 0x7FF;
+        std::uint64_t depth   = depth_bits(p_packet.depth);
+        // ------------------------- DECLARE ------------------------ //
+
+        if(p_bucket == bucket::opaque)
+            return (program << 51) | (vao << 35) | (texture << 24) | depth;
+        return (std::uint64_t(1) << 63) | ((0xFFFFFF - depth) << 39) | (program << 27) | (vao << 11) | texture;
+    }
+
+private:
+
+    // ================================================================ //
+    // ============================ METHODS =========================== //
+    // ================================================================ //
+
+    /**
+     * Positive floats compare like their bits: keep the 24 highest bits after the sign.
+     */
+    static std::uint64_t depth_bits(float p_depth)
+    {
+        std::uint32_t bits;
+        // ------------------------- DECLARE ------------------------ //
+
+        p_depth = p_depth > 0.f ? p_depth : 0.f;
+        std::memcpy(&bits, &p_depth, sizeof(bits));
+        return (bits >> 7) & 0xFFFFFF;
+    }
+
+    /**
+     * Draw p_packet, p_bound holds the textures left bound by the previous packet.
+     */
+    static void draw(const draw_packet& p_packet, draw_packet::texture_binding* p_bound)
+    {
+        p_packet.program->use();
+        for(std::size_t unit = 0; unit < draw_packet::max_textures; ++unit)
+        {
+            const draw_packet::texture_binding& texture = p_packet.textures[unit];
+            if(texture.id)
+            {
+                gl_object_texture::gl_bind(unit, texture.target, texture.id);
+                p_bound[unit] = texture;
+            }
+            else if(p_bound[unit].id)
+            {
+                gl_object_texture::gl_bind(unit, p_bound[unit].target, 0);
+                p_bound[unit].id = 0;
+            }
+        }
+        if(p_packet.uniforms)
+            p_packet.uniforms(*p_packet.program);
+        if(p_packet.instance_count)
+            gl_draw_instanced(*p_packet.vao, p_packet.instance_count);
+        else
+            gl_draw(*p_packet.vao);
+    }
+
+    // ================================================================ //
+    // ============================= FIELDS =========================== //
+    // ================================================================ //
+
+    /** The packets, in push order. */
+    std::vector<draw_packet>        m_packets;
+    /** The keys of the packets. */
+    std::vector<priv::sort_item>    m_items;
+    /** Buffer for the sort. */
+    std::vector<priv::sort_item>    m_tmp;
+    /** The threads used to sort. */
+    priv::worker_pool               m_pool;
+};
+
+} /* namespace extension */
+} /* namespace mgl */
+
+#endif /* EXTENSION_RENDER_QUEUE_HPP_ */
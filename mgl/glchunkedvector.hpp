@@ -0,0 +1,355 @@
+/*
+ * glchunkedvector.hpp
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: nemikolh
+ */
+
+#ifndef GLCHUNKEDVECTOR_HPP_
+#define GLCHUNKEDVECTOR_HPP_
+
+#include <vector>
+#include <memory>
+#include <cassert>
+#include "glvector.hpp"
+
+namespace mgl {
+
+/**
+ * @ingroup attributes
+ * @brief gl_chunked_vector is a sequence of OpenGL buffers of fixed size, growing without copy.
+ *
+ * Growing a gl_vector moves its whole content to a new buffer. The gl_chunked_vector allocates
+ * one more chunk of chunk_size() elements instead, thus push_back stays O(1), and the elements
+ * never move once written, except by erase. All the chunks are full but the last one.
+ *
+ * Like gl_vector, the elements are accessed while the container is mapped:
+ *  @code
+ *      mgl::gl_chunked_vector<trail_point> trail(4096);
+ *      {
+ *          auto lock = mgl::bind_at_scope(trail);
+ *          trail.push_back(point);
+ *          trail.erase(expired);   // the last point takes its place.
+ *      }
+ *      mgl::gl_draw(format, trail, GL_POINTS);
+ *  @endcode
+ * Only the chunks actually accessed are mapped, an append maps the last chunk only.
+ *
+ * A single draw can't read from several buffers: the chunks are drawn one after the other,
+ * with one glBindVertexBuffer per chunk (see gl_draw with a gl_vertex_format), or with one vao
+ * per chunk made with chunk(i) when the separate attribute format isn't available.
+ */
+template<typename T, typename Buff>
+class gl_chunked_vector
+{
+public:
+
+    // ================================================================ //
+    // ============================= TYPES ============================ //
+    // ================================================================ //
+
+    /** @brief The type of each chunk. */
+    typedef gl_vector<T, Buff>                      chunk_type;
+    /** @brief Size type. */
+    typedef typename chunk_type::size_type          size_type;
+    /** @brief Value type. */
+    typedef T                                       value_type;
+    /** @brief Reference type. */
+    typedef typename chunk_type::reference          reference;
+    /** @brief Const reference type. */
+    typedef typename chunk_type::const_reference    const_reference;
+
+    // ================================================================ //
+    // =========================== CTOR/DTOR ========================== //
+    // ================================================================ //
+
+    /**
+     * @brief Constructor, no allocation is performed on the GPU.
+     * @param p_chunk_size is the number of elements of each chunk.
+     */
+    explicit gl_chunked_vector(size_type p_chunk_size = 4096)
+        : m_chunks()
+        , m_chunk_mapped()
+        , m_chunk_size(p_chunk_size)
+        , m_size(0)
+        , m_mapped(0)
+    {
+#       ifndef MGL_NDEBUG
+        assert(p_chunk_size > 0);
+#       endif
+    }
+
+    gl_chunked_vector(const gl_chunked_vector&) = delete;
+    gl_chunked_vector& operator=(const gl_chunked_vector&) = delete;
+
+    ~gl_chunked_vector()
+    {
+        while(m_mapped)
+            unmap();
+    }
+
+    // ================================================================ //
+    // ============================ METHODS =========================== //
+    // ================================================================ //
+
+    /**
+     * @brief Add an element at the end, allocating a new chunk when the last one is full.
+     * The container must be mapped.
+     * @param p_val is the element to copy.
+     */
+    void push_back(const value_type& p_val)
+    {
+#       ifndef MGL_NDEBUG
+        assert(m_mapped);
+#       endif
+        // The chunks emptied by pop_back are kept: the last one isn't always the one to fill.
+        const size_type n = m_size / m_chunk_size;
+        // ------------------------- DECLARE ------------------------ //
+
+        if(n == m_chunks.size())
+            add_chunk();
+        chunk_type& last = mapped_chunk(n);
+        // The chunk never grows past its capacity, thus never moves.
+#       ifndef MGL_NDEBUG
+        assert(last.size() < last.capacity());
+#       endif
+        last.push_back(p_val);
+        ++m_size;
+    }
+
+    /**
+     * @brief Remove the element at p_n, replaced by the last element. The container must be mapped.
+     * @param p_n is the index of the element to remove.
+     */
+    void erase(size_type p_n)
+    {
+#       ifndef MGL_NDEBUG
+        assert(m_mapped && p_n < m_size);
+#       endif
+        if(p_n != m_size - 1)
+            (*this)[p_n] = back();
+        pop_back();
+    }
+
+    /**
+     * @brief Remove the last element. The chunk left empty is kept for the following appends.
+     *
+     * Like the other accesses, the chunk is mapped once and stays mapped while the container is.
+     */
+    void pop_back()
+    {
+#       ifndef MGL_NDEBUG
+        assert(m_size > 0);
+#       endif
+        map();
+        mapped_chunk((m_size - 1) / m_chunk_size).pop_back();
+        --m_size;
+        unmap();
+    }
+
+    /**
+     * @brief Remove all the elements, the chunks are kept.
+     *
+     * The chunks holding elements are mapped once for the whole operation.
+     */
+    void clear()
+    {
+        map();
+        for(size_type i = 0; i < m_chunks.size(); ++i)
+            if(!m_chunks[i]->empty())
+                mapped_chunk(i).clear();
+        m_size = 0;
+        unmap();
+    }
+
+    /**
+     * @brief Remove the empty chunks.
+     */
+    void shrink_to_fit()
+    {
+        const size_type used = (m_size + m_chunk_size - 1) / m_chunk_size;
+        // ------------------------- DECLARE ------------------------ //
+
+        for(size_type i = used; i < m_chunks.size(); ++i)
+            if(m_chunk_mapped[i])
+                m_chunks[i]->unmap();
+        m_chunks.resize(used);
+        m_chunk_mapped.resize(used);
+    }
+
+    reference
+    operator[](size_type p_n)
+    {
+#       ifndef MGL_NDEBUG
+        assert(m_mapped && p_n < m_size);
+#       endif
+        return mapped_chunk(p_n / m_chunk_size)[p_n % m_chunk_size];
+    }
+
+    const_reference
+    operator[](size_type p_n) const
+    {
+#       ifndef MGL_NDEBUG
+        assert(m_mapped && p_n < m_size);
+#       endif
+        return mapped_chunk(p_n / m_chunk_size)[p_n % m_chunk_size];
+    }
+
+    reference
+    back()                  { return (*this)[m_size - 1];   }
+
+    const_reference
+    back() const            { return (*this)[m_size - 1];   }
+
+    size_type
+    size() const            { return m_size;                }
+
+    bool
+    empty() const           { return m_size == 0;           }
+
+    size_type
+    capacity() const        { return m_chunks.size() * m_chunk_size; }
+
+    /**
+     * @brief Returns the number of elements of each chunk.
+     */
+    size_type
+    chunk_size() const      { return m_chunk_size;          }
+
+    /**
+     * @brief Returns the number of chunks, empty chunks included.
+     */
+    size_type
+    chunk_count() const     { return m_chunks.size();       }
+
+    /**
+     * @brief Returns the p_n-th chunk, to bind it to a vao for instance.
+     * The chunk keeps its buffer for its whole lifetime.
+     */
+    const chunk_type&
+    chunk(size_type p_n) const
+    {
+        return *m_chunks[p_n];
+    }
+
+    /**
+     * @brief This function allows to know the OpenGL mapping state of this container.
+     */
+    bool is_mapped() const
+    {
+        return m_mapped;
+    }
+
+private:
+
+    // ================================================================ //
+    // ============================ FRIENDS =========================== //
+    // ================================================================ //
+
+    template<typename> friend class gl_scope;
+
+    // ================================================================ //
+    // ============================ METHODS =========================== //
+    // ================================================================ //
+
+    /**
+     * \brief Map the container, the chunks are mapped when first accessed.
+     */
+    void map() const
+    {
+        ++m_mapped;
+    }
+
+    /**
+     * \brief Unmap the container, and the chunks mapped since the first map.
+     */
+    void unmap() const
+    {
+#ifndef MGL_NDEBUG
+        assert(m_mapped > 0);
+#endif
+        if(--m_mapped)
+            return;
+        for(size_type i = 0; i < m_chunks.size(); ++i)
+        {
+            if(m_chunk_mapped[i])
+                m_chunks[i]->unmap();
+            m_chunk_mapped[i] = false;
+        }
+    }
+
+    chunk_type& mapped_chunk(size_type p_n) const
+    {
+        if(!m_chunk_mapped[p_n])
+        {
+            m_chunks[p_n]->map();
+            m_chunk_mapped[p_n] = true;
+        }
+        return *m_chunks[p_n];
+    }
+
+    void add_chunk()
+    {
+        std::unique_ptr<chunk_type> chunk(new chunk_type());
+        // ------------------------- DECLARE ------------------------ //
+
+        chunk->reserve(m_chunk_size);
+        m_chunks.push_back(std::move(chunk));
+        m_chunk_mapped.push_back(false);
+    }
+
+    // ================================================================ //
+    // ============================= FIELDS =========================== //
+    // ================================================================ //
+
+    /** The chunks, the allocators keep a pointer on their vector thus they must not move. */
+    std::vector<std::unique_ptr<chunk_type>>    m_chunks;
+    /** True for the chunks mapped by this container. */
+    mutable std::vector<bool>                   m_chunk_mapped;
+    /** The number of elements of each chunk. */
+    size_type                                   m_chunk_size;
+    /** The number of elements. */
+    size_type                                   m_size;
+    /** The mapping state. */
+    mutable unsigned int                        m_mapped;
+};
+
+/**
+ * @brief Specialization of gl_scope for the gl_chunked_vector type.
+ *
+ * The chunks accessed during the scope are unmapped in the destructor.
+ */
+template<typename T, typename B>
+class gl_scope<gl_chunked_vector<T, B>>
+{
+public:
+    // ================================================================ //
+    // =========================== CTOR/DTOR ========================== //
+    // ================================================================ //
+
+    /**
+     * @brief Construct a scope object to map at scope the passed gl_chunked_vector.
+     * @param p_vector is the instance object that will be mapped.
+     */
+    gl_scope(const gl_chunked_vector<T, B> & p_vector)
+        : m_obj(p_vector)
+    {
+        m_obj.map();
+    }
+
+    /**
+     * @brief Destructor, unmap the underlying chunks.
+     */
+    ~gl_scope()
+    {
+        m_obj.unmap();
+    }
+
+private:
+
+    const gl_chunked_vector<T, B>& m_obj;
+};
+
+} /* namespace mgl */
+
+#endif /* GLCHUNKEDVECTOR_HPP_ */
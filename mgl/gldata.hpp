@@ -9,8 +9,11 @@
 #ifndef GLDATA_HPP_
 #define GLDATA_HPP_
 
+#include <type_traits>
 #include "type/gltraits.hpp"
 #include "meta/glutil.hpp"
+#include "meta/gltuplesize.hpp"
+#include "meta/glmhelper.hpp"
 
 #include "preprocessor/glpreprocessor_types.hpp"
 #include "preprocessor/glpreprocessor_control.hpp"
@@ -86,8 +89,11 @@ struct struct_member_name<STRUCT_NAME, INDEX>                       \
 {                                                                   \
     typedef char const* type;                                       \
                                                                     \
-    static type call()                                              \
+    static constexpr type call()                                    \
     { return IMPL_MGL_TO_STR(IMPL_MGL_CAPTURE_SECOND(MEMBER_NAME)); }\
+                                                                    \
+    static constexpr std::uint32_t hash =                           \
+        priv::hash_str(IMPL_MGL_TO_STR(IMPL_MGL_CAPTURE_SECOND(MEMBER_NAME)));\
 };
 
 #define IMPL_MGL_DEFINE_MEMBERS_NAMES(NAME, ATTRIBUTES) \
@@ -199,6 +205,12 @@ struct struct_member_name<STRUCT_NAME, INDEX>                       \
  *      ...
  *  @endcode
  * Notes :
+ *  - The integer members (char, short, int, their unsigned variants and glm::ivec*, glm::uvec*)
+ *    are read by the shaders as integers, declared as int, uint, ivec* or uvec*. A shader reading
+ *    them as float or vec* (colors stored as bytes for instance) gets undefined values, without
+ *    any error: such members must be declared normalized with mgl::attribute_normalized.
+ *  - The doubles are read as double or dvec* when OpenGL 4.1 or ARB_vertex_attrib_64bit is
+ *    available, and converted to float otherwise (see mgl::gl_vertex_layout::location).
  *  - You can't prefix an attribute with "gl_", if you do so the
  *    program will not link. No check is performed on it there, so
  *    it's your job to use it properly.
@@ -240,38 +252,90 @@ struct struct_member_name<STRUCT_NAME, INDEX>                       \
         }
 
 /**
- * @}
+ * Check that the declared type of an adapted attribute is the type of the member.
  */
-//MGL_DEFINE_TEST(,test, (int, gg)(float, op))
+#define IMPL_MGL_CHECK_ADAPTED_MEMBER(ATTRIBUTE, INDEX, NAME)                            \
+        static_assert(std::is_same<decltype(NAME::IMPL_MGL_CAPTURE_SECOND(ATTRIBUTE)),  \
+                                   IMPL_MGL_CAPTURE_FIRST(ATTRIBUTE)>::value,           \
+                      "The type of " IMPL_MGL_TO_STR(IMPL_MGL_CAPTURE_SECOND(ATTRIBUTE))\
+                      " doesn't match the declaration of the structure.");
+
+#define IMPL_MGL_CHECK_ADAPTED_MEMBERS(NAME, ATTRIBUTES)    \
+        IMPL_MGL_FOR_EACH(                                  \
+                    IMPL_MGL_FILLER(ATTRIBUTES),            \
+                    IMPL_MGL_CHECK_ADAPTED_MEMBER,          \
+                    NAME)
 
 /**
- * Macro to adapt existing attributes data.
- * ----------------------------------------------------------------
+ * @brief Macro to adapt an existing structure as attributes data.
+ *
  * Usage :
- * -------
+ *  @code
+ *      namespace sim {
+ *      struct particle
+ *      {
+ *          glm::vec3   position;
+ *          glm::vec3   velocity;
+ *          float       mass;
+ *      };
+ *      }
  *
- *  Same as NKH_DEFINE_GL_ATTRIBUTES but does not have an instrusive
- *  behavior. However whenever the original structure is modified,
- *  you have also to report the modification within the macro
- *  declaration.
+ *      MGL_ADAPT_TO_GL_ATTRIBUTES(
+ *          sim::particle,
+ *          (glm::vec3, position)
+ *          (float    , mass)
+ *      )
+ *  @endcode
+ * Same as #MGL_DEFINE_GL_ATTRIBUTES, but the structure is not modified: the elements of a
+ * std::vector<sim::particle> of the simulation are the elements of a mgl::gl_vector<sim::particle>,
+ * without repacking. gl_vector::append(v.data(), v.size()) copies them as one block, whereas
+ * assign copies them element by element.
+ *
+ * Notes :
+ *  - the macro must be used in the global namespace, and NAME must be fully qualified,
+ *  - only the listed members are attributes, the others are in the buffer
+ *    but are not bound. The stride is always sizeof(NAME),
+ *  - the type of each member is checked against the declaration of the structure,
+ *    but a member added to the structure is not detected, see #MGL_ADAPT_TO_GL_ATTRIBUTES_CHECKED_SIZE.
+ */
+#define MGL_ADAPT_TO_GL_ATTRIBUTES(NAME, ATTRIBUTES)    \
+        namespace mgl {                                 \
+        IMPL_MGL_CHECK_ADAPTED_MEMBERS(NAME, ATTRIBUTES)\
+        IMPL_MGL_DEFINE_MEMBERS_NAMES(NAME, ATTRIBUTES) \
+        IMPL_MGL_DEFINE_ATTRIBUTES_OFFSET_AT(NAME, ATTRIBUTES) \
+        IMPL_MGL_DEFINE_ATTRIBUTES_VALUE_AT(NAME, ATTRIBUTES) \
+        namespace priv {                                \
+        IMPL_MGL_DEFINE_IS_GL_ATTRIBUTE(NAME)           \
+        IMPL_MGL_DEFINE_SEQ_SIZE(                       \
+            NAME,                                       \
+            IMPL_MGL_FILLER(ATTRIBUTES))                \
+        }                                               \
+        }
+
+/**
+ * @brief Same as #MGL_ADAPT_TO_GL_ATTRIBUTES, with the expected size of the structure.
  *
- *  Note :
- *    - you can't adapt partially a structure, as computed offset are
- *      perform on the structure plus its sizeof isn't computed there. It
- *      could however maybe be an improvement to the library.
+ * Usage :
+ *  @code
+ *      MGL_ADAPT_TO_GL_ATTRIBUTES_CHECKED_SIZE(
+ *          sim::particle,
+ *          28,
+ *          (glm::vec3, position)
+ *          (float    , mass)
+ *      )
+ *  @endcode
+ * The compilation fails when sizeof(NAME) isn't SIZE, which is the case when a member
+ * is added to the structure or when its padding changes. The shaders, and the files written with
+ * mesh_file, can then be updated at the same time. SIZE is only checked: the stride of the
+ * buffer is still sizeof(NAME).
+ */
+#define MGL_ADAPT_TO_GL_ATTRIBUTES_CHECKED_SIZE(NAME, SIZE, ATTRIBUTES)         \
+        static_assert(sizeof(NAME) == (SIZE),                                   \
+                      "The size of " IMPL_MGL_TO_STR(NAME) " has changed, check its adaptation."); \
+        MGL_ADAPT_TO_GL_ATTRIBUTES(NAME, ATTRIBUTES)
+
+/**
+ * @}
  */
-//#define MGL_ADAPT_TO_GL_ATTRIBUTES(NAME, ATTRIBUTES)                                            \
-//        BOOST_FUSION_ADAPT_STRUCT(NAME, ATTRIBUTES)                                             \
-//        namespace mgl  {                                                                        \
-//        namespace priv {                                                                        \
-//            struct is_gl_attributes<NAME>                                                       \
-//            {                                                                                   \
-//                static constexpr bool value = true;                                             \
-//            };                                                                                  \
-//        }                                                                                       \
-//        }                                                                                       \
-//        IMPL_MGL_DEFINE_ATTRIBUTES_OFFSET_AT(                                                   \
-//                NAME,                                                                           \
-//                ATTRIBUTES)
 
 #endif /* GLDATA_HPP_ */
@@ -8,7 +8,9 @@
 #ifndef GLUTIL_HPP_
 #define GLUTIL_HPP_
 
+#include <vector>
 #include "glfwd.hpp"
+#include "type/gldrawcommand.hpp"
 
 namespace mgl {
 
@@ -22,13 +24,15 @@ namespace mgl {
  * will be less than the minimum size of the buffers marked as
  * instanced.
  * Note :
- *  - Only if MGL_DEBUG is active you'll get a check on primcount,
- *    otherwise you need to provide that parameter carefully.
+ *  - Unless MGL_NDEBUG is defined, you'll get a check that every instanced buffer
+ *    holds the instances drawn (see gl_vao::covers_instances), otherwise you need
+ *    to provide these parameters carefully.
  * @param p_vao holds both the object data and the per instance data.
  * @param p_primcount is the number of instance to draw.
+ * @param p_base_instance is the first element of the instanced buffers.
  */
 template<size_t dummy = 0>
-void gl_draw_instanced(const gl_vao& p_vao, std::size_t p_primcount);
+void gl_draw_instanced(const gl_vao& p_vao, std::size_t p_primcount, std::size_t p_base_instance = 0);
 
 /**
  * @brief Draw the passed vao.
@@ -45,6 +49,26 @@ void gl_draw(const gl_vao& p_vao, const gl_program& p_material);
 template<size_t dummy = 0>
 void gl_draw(const gl_vao& p_vao);
 
+/**
+ * @brief Draw the passed range of the vao, assuming a gl_program is already being used.
+ *
+ * Uses glDrawElements* when the vao has an element buffer, glDrawArrays* otherwise,
+ * picking the simplest call able to express the range. The range must lie in the vao, which is
+ * asserted in debug builds; a count of gl_draw_range::all draws up to the end.
+ * Without GL 4.2 or ARB_base_instance, the base instance is applied by offsetting
+ * the instanced buffers of the vao (see gl_vao::offset_instances).
+ * @param p_vao is the vao to draw.
+ * @param p_range tells the mode, the range, the base vertex and the instances to draw.
+ */
+template<size_t dummy = 0>
+void gl_draw(const gl_vao& p_vao, const gl_draw_range& p_range);
+
+/**
+ * @brief Draw the passed range of the vao with p_material.
+ */
+template<size_t dummy = 0>
+void gl_draw(const gl_vao& p_vao, const gl_program& p_material, const gl_draw_range& p_range);
+
 /**
  * @brief Draw the passed data.
  * @param p_data is the attributes data to use.
@@ -64,6 +88,73 @@ template<typename T, typename I>
 void gl_draw(const gl_vector<T> & p_data, const gl_vector<I> & p_indices);
 
 
+/**
+ * @brief Draw one mesh per command, in a single call.
+ *
+ * Every mesh lives in the buffers of p_vao, the commands tell which range of the element
+ * buffer to draw, with which base vertex and instances. Uses glMultiDrawElementsIndirect
+ * when available, otherwise the commands are read back and drawn with glMultiDrawElementsBaseVertex,
+ * or one call per command if they are instanced. Without base instance (OpenGL 4.2 or
+ * ARB_base_instance), these calls attach the instanced buffers of p_vao at the base instance
+ * of each command instead.
+ * The draw indirect buffer requires OpenGL 4.0, use the std::vector overload below.
+ * The buffer of commands is bound to GL_DRAW_INDIRECT_BUFFER whatever the target of B, so that
+ * the commands filled on the GPU (see extension::gpu_culler) can be drawn as they are.
+ * @param p_vao holds the meshes, it must have an element buffer.
+ * @param p_commands is the buffer of commands.
+ * @param p_mode is the primitive mode.
+ */
+template<typename B>
+void gl_draw_indirect(const gl_vao& p_vao, const gl_vector<draw_elements_indirect_command, B>& p_commands, GLenum p_mode = GL_TRIANGLES);
+
+/**
+ * @brief Same as above, with the commands in client memory.
+ * Issues glMultiDrawElementsBaseVertex, or one call per command if they are instanced.
+ */
+template<size_t dummy = 0>
+void gl_draw_indirect(const gl_vao& p_vao, const std::vector<draw_elements_indirect_command>& p_commands, GLenum p_mode = GL_TRIANGLES);
+
+/**
+ * @brief Same as above, using p_material.
+ */
+template<typename Commands>
+void gl_draw_indirect(const gl_vao& p_vao, const gl_program& p_material, const Commands& p_commands, GLenum p_mode = GL_TRIANGLES);
+
+/**
+ * @brief Draw all the elements of a gl_chunked_vector, one glDrawArrays per chunk.
+ *
+ * The chunks are bound one after the other to p_format, which is left bound.
+ * The primitives can't span two chunks, a chunk size multiple of the vertices per primitive
+ * is expected. Requires the separate attribute format (OpenGL 4.3), see gl_vertex_format.
+ * @param p_format is the vertex format of T.
+ * @param p_vertices is the chunked vertex buffer.
+ * @param p_mode is the primitive mode.
+ */
+template<typename T, typename B>
+void gl_draw(const gl_vertex_format& p_format, const gl_chunked_vector<T, B>& p_vertices, GLenum p_mode = GL_POINTS);
+
+/**
+ * @brief Draw the vertices allocated in a gl_frame_allocator, with glDrawArrays.
+ *
+ * The slice is bound to p_format, which is left bound. Requires the separate attribute
+ * format (OpenGL 4.3), see gl_vertex_format.
+ * @param p_format is the vertex format of T.
+ * @param p_vertices is the slice of vertices.
+ * @param p_mode is the primitive mode.
+ */
+template<typename T>
+void gl_draw(const gl_vertex_format& p_format, const gl_frame_slice<T>& p_vertices, GLenum p_mode = GL_TRIANGLES);
+
+/**
+ * @brief Same as above, with indices allocated in the same gl_frame_allocator, with glDrawElements.
+ * @param p_format is the vertex format of T.
+ * @param p_vertices is the slice of vertices.
+ * @param p_indices is the slice of indices, relative to the first vertex of p_vertices.
+ * @param p_mode is the primitive mode.
+ */
+template<typename T, typename I>
+void gl_draw(const gl_vertex_format& p_format, const gl_frame_slice<T>& p_vertices, const gl_frame_slice<I>& p_indices,
+             GLenum p_mode = GL_TRIANGLES);
 
 } /* namespace mgl */
 
@@ -5,29 +5,45 @@
  *      Author: nemikolh
  */
 
+#include <limits>
 #include "meta/glbindattrib.hpp"
 #include "type/glvao.hpp"
 #include "type/glprogram.hpp"
 #include "glvector.hpp"
+#include "glchunkedvector.hpp"
+#include "memory/glframeallocator.hpp"
+#include "type/glvertexformat.hpp"
+#include "glscope.hpp"
+#include <algorithm>
 
 namespace mgl {
 
+namespace priv {
+
+/*
+ * Returns the size in bytes of the index type.
+ */
+inline std::size_t index_size(GLenum p_type)
+{
+    switch(p_type)
+    {
+        case GL_UNSIGNED_BYTE:  return 1;
+        case GL_UNSIGNED_SHORT: return 2;
+        default:                return 4;
+    }
+}
+
+} /* namespace priv */
+
 /*
  * Implementation details.
  */
 template<size_t dummy>
-void gl_draw_instanced(const gl_vao& p_vao, std::size_t p_primcount)
+void gl_draw_instanced(const gl_vao& p_vao, std::size_t p_primcount, std::size_t p_base_instance)
 {
-#   ifndef MGL_NDEBUG
-    assert(p_vao.size_instanced() == 0 || p_vao.size_instanced() >= p_primcount);
-#   endif
     // ------------------------- DECLARE ------------------------ //
 
-    // Bind the  vao.
-    p_vao.bind();
-
-    // Call to the draw. TODO: offer a way to deal with all primitives type.
-    glDrawElementsInstanced(GL_TRIANGLES, p_vao.size(), p_vao.elements_type(), 0, p_primcount);
+    gl_draw(p_vao, gl_draw_range().with_instances(p_primcount, p_base_instance));
 }
 
 /*
@@ -43,7 +59,7 @@ void gl_draw(const gl_vector<T> & p_data, const gl_vector<I> & p_indices, const
     p_data.bind();
 
     // Loop overs all the attributes of T to bind them to the program.
-    gl_bind_attributes<T>::map(gl_attribute_binder{p_program.id()});
+    gl_bind_attributes<T>::map(gl_attribute_binder{&p_program.attribute_locations()});
 
     // Use the passed program
     p_program.use();
@@ -56,7 +72,7 @@ void gl_draw(const gl_vector<T> & p_data, const gl_vector<I> & p_indices, const
  * Implementation details.
 */
 template<typename T, typename I>
-void gl_draw(const gl_vector<T> & p_data, const gl_vector<I> & p_indices)
+void gl_draw(const gl_vector<T> & /*p_data*/, const gl_vector<I> & p_indices)
 {
     static_assert(std::is_integral<I>::value, "Indices must be integral types, unsigned recommended.");
     // ------------------------- DECLARE ------------------------ //
@@ -64,7 +80,7 @@ void gl_draw(const gl_vector<T> & p_data, const gl_vector<I> & p_indices)
     // Bind the element buffer.
     p_indices.bind();
 
-    glDrawElements(GL_TRIANGLES, p_data.size(), gl_enum_from_type<I>::value, 0);
+    glDrawElements(GL_TRIANGLES, p_indices.size(), gl_enum_from_type<I>::value, 0);
 }
 
 /*
@@ -90,13 +106,233 @@ void gl_draw(const gl_vao& p_vao)
 {
     // ------------------------- DECLARE ------------------------ //
 
+    // TODO: perform a check between the VAO's expected layout for a program
+    // and the attributes layout of the program used.
+    gl_draw(p_vao, gl_draw_range());
+}
+
+/*
+ * Implementation details
+ */
+template<size_t dummy>
+void gl_draw(const gl_vao& p_vao, const gl_draw_range& p_range)
+{
+    // ------------------------- DECLARE ------------------------ //
+
     // Bind the vao.
     p_vao.bind();
 
-    // TODO: perform a check between the VAO's expected layout for a program
-    // and the attributes layout of the program used.
-    // TODO: Use the appropriate call when no ELEMENT_BUFFER is provided.
-    glDrawElements(GL_TRIANGLES, p_vao.size(), p_vao.elements_type(), 0);
+    const std::size_t size  = p_vao.size();
+#   ifndef MGL_NDEBUG
+    assert(p_range.first <= size);
+    assert(p_range.count == gl_draw_range::all || p_range.count <= size - p_range.first);
+    assert(p_vao.covers_instances(p_range.instance_count, p_range.base_instance));
+#   endif
+    const std::size_t first = std::min(p_range.first, size);
+    const std::size_t n     = std::min(p_range.count, size - first);
+#   ifndef MGL_NDEBUG
+    // The counts are given to OpenGL as GLsizei.
+    assert(n <= std::size_t(std::numeric_limits<GLsizei>::max()));
+    assert(p_range.instance_count <= std::size_t(std::numeric_limits<GLsizei>::max()));
+    assert(p_vao.elements_type() || first <= std::size_t(std::numeric_limits<GLint>::max()));
+#   endif
+    const GLsizei     count = static_cast<GLsizei>(n);
+    const GLsizei     instances = static_cast<GLsizei>(p_range.instance_count);
+    GLuint            base_instance = p_range.base_instance;
+
+    if(!priv::has_base_instance())
+    {
+        // Move the instanced buffers instead.
+        p_vao.offset_instances(base_instance);
+        base_instance = 0;
+    }
+
+    if(!p_vao.elements_type())
+    {
+        // No element buffer, the range is in vertices.
+        if(base_instance)
+            glCheck(glDrawArraysInstancedBaseInstance(p_range.mode, static_cast<GLint>(first), count, instances, base_instance));
+        else if(instances != 1)
+            glCheck(glDrawArraysInstanced(p_range.mode, static_cast<GLint>(first), count, instances));
+        else
+            glCheck(glDrawArrays(p_range.mode, static_cast<GLint>(first), count));
+        return;
+    }
+
+    const GLvoid* offset = reinterpret_cast<const GLvoid*>(first * priv::index_size(p_vao.elements_type()));
+    if(base_instance)
+        glCheck(glDrawElementsInstancedBaseVertexBaseInstance(p_range.mode, count, p_vao.elements_type(), offset,
+                                                              instances, p_range.base_vertex, base_instance));
+    else if(instances != 1)
+        glCheck(glDrawElementsInstancedBaseVertex(p_range.mode, count, p_vao.elements_type(), offset,
+                                                  instances, p_range.base_vertex));
+    else if(p_range.base_vertex)
+        glCheck(glDrawElementsBaseVertex(p_range.mode, count, p_vao.elements_type(), offset, p_range.base_vertex));
+    else
+        glCheck(glDrawElements(p_range.mode, count, p_vao.elements_type(), offset));
+}
+
+/*
+ * Implementation details
+ */
+template<size_t dummy>
+void gl_draw(const gl_vao& p_vao, const gl_program& p_material, const gl_draw_range& p_range)
+{
+    // ------------------------- DECLARE ------------------------ //
+
+    p_material.use();
+    gl_draw(p_vao, p_range);
+}
+
+namespace priv {
+
+/*
+ * Draw the commands without the draw indirect buffer.
+ */
+inline void draw_commands(const gl_vao& p_vao, const draw_elements_indirect_command* p_commands, std::size_t p_size, GLenum p_mode)
+{
+    const std::size_t index_size = priv::index_size(p_vao.elements_type());
+    bool instanced = false;
+    // ------------------------- DECLARE ------------------------ //
+
+    for(std::size_t i = 0; i < p_size; ++i)
+        instanced = instanced || p_commands[i].instance_count != 1 || p_commands[i].base_instance != 0;
+
+    if(!instanced)
+    {
+        std::vector<GLsizei>        counts(p_size);
+        std::vector<const GLvoid*>  offsets(p_size);
+        std::vector<GLint>          base_vertices(p_size);
+        for(std::size_t i = 0; i < p_size; ++i)
+        {
+            counts[i]        = p_commands[i].count;
+            offsets[i]       = reinterpret_cast<const GLvoid*>(p_commands[i].first_index * index_size);
+            base_vertices[i] = p_commands[i].base_vertex;
+        }
+        if(!priv::has_base_instance())
+            p_vao.offset_instances(0);
+        glCheck(glMultiDrawElementsBaseVertex(p_mode, counts.data(), p_vao.elements_type(), offsets.data(), p_size, base_vertices.data()));
+        return;
+    }
+
+    for(std::size_t i = 0; i < p_size; ++i)
+    {
+        const draw_elements_indirect_command& c = p_commands[i];
+        const GLvoid* offset = reinterpret_cast<const GLvoid*>(c.first_index * index_size);
+        GLuint base_instance = c.base_instance;
+        if(!priv::has_base_instance())
+        {
+            p_vao.offset_instances(base_instance);
+            base_instance = 0;
+        }
+        if(base_instance)
+            glCheck(glDrawElementsInstancedBaseVertexBaseInstance(p_mode, c.count, p_vao.elements_type(), offset,
+                                                                  c.instance_count, c.base_vertex, base_instance));
+        else
+            glCheck(glDrawElementsInstancedBaseVertex(p_mode, c.count, p_vao.elements_type(), offset,
+                                                      c.instance_count, c.base_vertex));
+    }
+}
+
+} /* namespace priv */
+
+/*
+ * Implementation details
+ */
+template<typename B>
+void gl_draw_indirect(const gl_vao& p_vao, const gl_vector<draw_elements_indirect_command, B>& p_commands, GLenum p_mode)
+{
+    // ------------------------- DECLARE ------------------------ //
+
+#   ifndef MGL_NDEBUG
+    assert(p_vao.elements_type() != 0);
+#   endif
+    p_vao.bind();
+
+    if(priv::has_multi_draw_indirect())
+    {
+        gl_object_buffer<gl_buffer_target<GL_DRAW_INDIRECT_BUFFER>>::gl_bind(p_commands.id());
+        glCheck(glMultiDrawElementsIndirect(p_mode, p_vao.elements_type(), nullptr, p_commands.size(), 0));
+        return;
+    }
+
+    gl_scope<gl_vector<draw_elements_indirect_command, B>> scope(p_commands);
+    priv::draw_commands(p_vao, p_commands.data(), p_commands.size(), p_mode);
+}
+
+/*
+ * Implementation details
+ */
+template<size_t dummy>
+void gl_draw_indirect(const gl_vao& p_vao, const std::vector<draw_elements_indirect_command>& p_commands, GLenum p_mode)
+{
+    // ------------------------- DECLARE ------------------------ //
+
+#   ifndef MGL_NDEBUG
+    assert(p_vao.elements_type() != 0);
+#   endif
+    p_vao.bind();
+    priv::draw_commands(p_vao, p_commands.data(), p_commands.size(), p_mode);
+}
+
+/*
+ * Implementation details
+ */
+template<typename Commands>
+void gl_draw_indirect(const gl_vao& p_vao, const gl_program& p_material, const Commands& p_commands, GLenum p_mode)
+{
+    // ------------------------- DECLARE ------------------------ //
+
+    p_material.use();
+    gl_draw_indirect(p_vao, p_commands, p_mode);
+}
+
+/*
+ * Implementation details
+ */
+template<typename T, typename B>
+void gl_draw(const gl_vertex_format& p_format, const gl_chunked_vector<T, B>& p_vertices, GLenum p_mode)
+{
+    std::size_t left = p_vertices.size();
+    // ------------------------- DECLARE ------------------------ //
+
+    p_format.bind();
+    for(std::size_t i = 0; left; ++i)
+    {
+        const std::size_t count = std::min(left, p_vertices.chunk_size());
+        p_format.bind_vertex_buffer(p_vertices.chunk(i));
+        glCheck(glDrawArrays(p_mode, 0, count));
+        left -= count;
+    }
+}
+
+/*
+ * Implementation details
+ */
+template<typename T>
+void gl_draw(const gl_vertex_format& p_format, const gl_frame_slice<T>& p_vertices, GLenum p_mode)
+{
+    p_format.bind();
+    p_format.bind_vertex_buffer(p_vertices);
+    glCheck(glDrawArrays(p_mode, 0, p_vertices.count));
+}
+
+/*
+ * Implementation details
+ */
+template<typename T, typename I>
+void gl_draw(const gl_vertex_format& p_format, const gl_frame_slice<T>& p_vertices, const gl_frame_slice<I>& p_indices,
+             GLenum p_mode)
+{
+    static_assert(std::is_integral<I>::value, "The indices must be integers.");
+    // ------------------------- DECLARE ------------------------ //
+
+    p_format.bind();
+    p_format.bind_vertex_buffer(p_vertices);
+    // The element buffer binding is part of the vao state.
+    gl_object_buffer<gl_buffer_type<I>>::gl_bind(p_indices.buffer);
+    glCheck(glDrawElements(p_mode, p_indices.count, gl_enum_from_type<I>::value,
+                           reinterpret_cast<const GLvoid*>(p_indices.offset)));
 }
 
 } /* namespace mgl */
@@ -168,6 +168,33 @@ public:
     {}
 };
 
+/**
+ * @brief Exception thrown when a mesh file can't be read or doesn't match the expected attributes.
+ */
+class gl_mesh_file_error : public gl_exception_specific
+{
+public:
+    gl_mesh_file_error(const char* p_what)
+        : gl_exception_specific("invalid mesh file: ", p_what)
+    {}
+
+    gl_mesh_file_error(std::string p_what)
+        : gl_mesh_file_error(p_what.c_str())
+    {}
+};
+
+/**
+ * @brief Exception thrown when an attribute can't be given a location, as a simple buffer
+ * bound to a vao made without program and without location.
+ */
+class gl_unknown_location : public gl_exception_specific
+{
+public:
+    gl_unknown_location(const char* p_what)
+        : gl_exception_specific("no location for the attribute ", p_what)
+    {}
+};
+
 }  /* namespace mgl */
 
 #endif /* GLEXCEPTIONS_HPP_ */
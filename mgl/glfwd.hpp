@@ -59,6 +59,19 @@ bool operator==(const gl_allocator<T, C1, B1>& p_a, const gl_allocator<U, C2, B2
 template<typename T, typename Buff = gl_buffer_type<T>>
 class gl_vector;
 
+/* Forward declaration for the gl_chunked_vector type. */
+template<typename T, typename Buff = gl_buffer_type<T>>
+class gl_chunked_vector;
+
+/* Forward declaration of the gl_frame_allocator allocations. */
+template<typename T>
+struct gl_frame_slice;
+template<typename T>
+class gl_frame_view;
+
+/* Forward declaration of gl_vertex_format. */
+class gl_vertex_format;
+
 /* Forward declaration of gl_vao. */
 struct gl_vao;
 
@@ -67,7 +80,7 @@ struct gl_program;
 
 /* Forward declaration of gl_simple_buffer. */
 template<typename T, typename B>
-class gl_simple_buffer;
+struct gl_simple_buffer;
 
 /* Forward declaration of gl_instanced. */
 template<typename T>
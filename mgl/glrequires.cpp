@@ -115,6 +115,70 @@ bool glCheckError(const char* file, unsigned int line)
     return true;
 }
 
+namespace {
+
+bool direct_state_access_enabled = true;
+
+}
+
+bool has_direct_state_access()
+{
+#ifdef MGL_NO_DSA
+    return false;
+#else
+    static const bool available = GLEW_VERSION_4_5 || GLEW_ARB_direct_state_access;
+    return available && direct_state_access_enabled;
+#endif
+}
+
+void set_direct_state_access(bool p_enabled)
+{
+    direct_state_access_enabled = p_enabled;
+}
+
+bool has_multi_draw_indirect()
+{
+#ifdef MGL_NO_MULTI_DRAW_INDIRECT
+    return false;
+#else
+    static const bool available = GLEW_VERSION_4_3 || GLEW_ARB_multi_draw_indirect;
+    return available;
+#endif
+}
+
+bool has_base_instance()
+{
+#ifdef MGL_NO_BASE_INSTANCE
+    return false;
+#else
+    static const bool available = GLEW_VERSION_4_2 || GLEW_ARB_base_instance;
+    return available;
+#endif
+}
+
+bool has_vertex_attrib_64bit()
+{
+#ifdef MGL_NO_VERTEX_ATTRIB_64BIT
+    return false;
+#else
+    static const bool available = GLEW_VERSION_4_1 || GLEW_ARB_vertex_attrib_64bit;
+    return available;
+#endif
+}
+
+bool has_compute_shader()
+{
+    static const bool available = GLEW_VERSION_4_3
+                               || (GLEW_ARB_compute_shader && GLEW_ARB_shader_storage_buffer_object);
+    return available;
+}
+
+bool has_buffer_storage()
+{
+    static const bool available = GLEW_VERSION_4_4 || GLEW_ARB_buffer_storage;
+    return available;
+}
+
 } /* namespace priv */
 
 
@@ -50,6 +50,54 @@ bool glCheckError(const char* file, unsigned int line);
  */
 void glTryError();
 
+/**
+ * \brief Returns true when the direct state access functions (OpenGL 4.5
+ * or ARB_direct_state_access) can be used. The result is queried once, so the
+ * first call must be made after glewInit. Define MGL_NO_DSA to always return false.
+ */
+bool has_direct_state_access();
+
+/**
+ * \brief Disable the direct state access functions at runtime, to work around a driver or to
+ * compare both paths, or enable them again when available. No buffer may be mapped when the
+ * path changes, and the objects created by one path stay valid with the other.
+ */
+void set_direct_state_access(bool p_enabled);
+
+/**
+ * \brief Returns true when glMultiDrawElementsIndirect (OpenGL 4.3 or
+ * ARB_multi_draw_indirect) can be used. Define MGL_NO_MULTI_DRAW_INDIRECT to always
+ * return false.
+ */
+bool has_multi_draw_indirect();
+
+/**
+ * \brief Returns true when the draws can offset the instanced arrays by a base
+ * instance (OpenGL 4.2 or ARB_base_instance). Define MGL_NO_BASE_INSTANCE to always
+ * return false.
+ */
+bool has_base_instance();
+
+/**
+ * \brief Returns true when the double attributes can be fetched without conversion to
+ * float by glVertexAttribLPointer and glVertexAttribLFormat (OpenGL 4.1 or ARB_vertex_attrib_64bit).
+ * Otherwise they are converted to float, see gl_vertex_layout::location(). Define
+ * MGL_NO_VERTEX_ATTRIB_64BIT to always return false.
+ */
+bool has_vertex_attrib_64bit();
+
+/**
+ * \brief Returns true when compute shaders and shader storage buffers (OpenGL 4.3,
+ * or ARB_compute_shader and ARB_shader_storage_buffer_object) can be used.
+ */
+bool has_compute_shader();
+
+/**
+ * \brief Returns true when immutable buffers can be persistently mapped (OpenGL 4.4
+ * or ARB_buffer_storage).
+ */
+bool has_buffer_storage();
+
 } /* namespace priv */
 
 
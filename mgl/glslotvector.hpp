@@ -0,0 +1,380 @@
+/*
+ * glslotvector.hpp
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: nemikolh
+ */
+
+#ifndef GLSLOTVECTOR_HPP_
+#define GLSLOTVECTOR_HPP_
+
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cassert>
+#include "glvector.hpp"
+#include "meta/glinstanced.hpp"
+
+namespace mgl {
+
+/**
+ * @brief Handle on an element of a gl_slot_vector.
+ *
+ * The handle stays valid until the element is erased, whatever the other insertions and
+ * removals. Afterwards, the generation doesn't match anymore and the handle is rejected,
+ * even if the slot is reused.
+ */
+struct gl_slot_handle
+{
+    /** The slot of the element. */
+    std::uint32_t   index;
+    /** The generation of the slot when the element has been inserted. */
+    std::uint32_t   generation;
+
+    bool operator==(const gl_slot_handle& p_rhs) const
+    {
+        return index == p_rhs.index && generation == p_rhs.generation;
+    }
+
+    bool operator!=(const gl_slot_handle& p_rhs) const
+    {
+        return !(*this == p_rhs);
+    }
+};
+
+/**
+ * @ingroup attributes
+ * @brief gl_slot_vector keeps per instance data packed in a buffer, behind stable handles.
+ *
+ * The elements are stored contiguously, in [0, size()[, so that they can be drawn with a single
+ * instanced draw. Erasing an element moves the last one in its place (O(1)), the handles follow
+ * the elements through an indirection table whose free slots are reused by the insertions.
+ *
+ * The elements are edited in client memory, the buffer is updated by upload(), which only sends
+ * the elements inserted, moved or modified since the previous upload, coalesced into ranges:
+ *  @code
+ *      mgl::gl_slot_vector<instance> instances;
+ *      mgl::gl_vao vao = program.make_vao(mesh, indices, mgl::make_instanced(instances));
+ *      mgl::gl_slot_handle h = instances.insert(instance{ ... });
+ *      instances.modify(h).color = glm::vec4(1.f);
+ *      instances.erase(other);
+ *      instances.upload();
+ *      mgl::gl_draw_instanced(vao, instances.size());
+ *  @endcode
+ * compact() should be called from time to time, to release the memory of the removed elements.
+ * The order of the elements in the buffer isn't preserved by the removals.
+ */
+template<typename T, typename Buff = gl_buffer_type<T>>
+class gl_slot_vector
+{
+public:
+
+    // ================================================================ //
+    // ============================= TYPES ============================ //
+    // ================================================================ //
+
+    /** @brief The type of the buffer. */
+    typedef gl_vector<T, Buff>      buffer_type;
+    /** @brief Size type. */
+    typedef std::size_t             size_type;
+    /** @brief Value type. */
+    typedef T                       value_type;
+
+    // ================================================================ //
+    // =========================== CTOR/DTOR ========================== //
+    // ================================================================ //
+
+    /**
+     * @brief Default constructor, no allocation is performed on the GPU.
+     */
+    gl_slot_vector()
+        : m_values()
+        , m_owners()
+        , m_slots()
+        , m_free(no_slot)
+        , m_dirty()
+        , m_is_dirty()
+        , m_buffer()
+    {}
+
+    gl_slot_vector(const gl_slot_vector&) = delete;
+    gl_slot_vector& operator=(const gl_slot_vector&) = delete;
+
+    // ================================================================ //
+    // ============================ METHODS =========================== //
+    // ================================================================ //
+
+    /**
+     * @brief Add an element, sent to the buffer at the next upload.
+     * @param p_value is the element.
+     * @return Returns the handle of the element.
+     */
+    gl_slot_handle insert(const value_type& p_value)
+    {
+        std::uint32_t index = m_free;
+        // ------------------------- DECLARE ------------------------ //
+
+        if(index == no_slot)
+        {
+            index = static_cast<std::uint32_t>(m_slots.size());
+            m_slots.push_back(slot{0, 0});
+        }
+        else
+            m_free = m_slots[index].position;
+
+        m_slots[index].position = static_cast<std::uint32_t>(m_values.size());
+        m_values.push_back(p_value);
+        m_owners.push_back(index);
+        m_is_dirty.push_back(false);
+        mark_dirty(m_values.size() - 1);
+        return gl_slot_handle{index, m_slots[index].generation};
+    }
+
+    /**
+     * @brief Remove an element, the last element takes its place.
+     * @param p_handle is the handle of the element.
+     * @return Returns false if the handle was already invalid.
+     */
+    bool erase(const gl_slot_handle& p_handle)
+    {
+        if(!contains(p_handle))
+            return false;
+
+        slot& removed = m_slots[p_handle.index];
+        const std::uint32_t position = removed.position;
+        const std::uint32_t last = static_cast<std::uint32_t>(m_values.size() - 1);
+        // ------------------------- DECLARE ------------------------ //
+
+        if(position != last)
+        {
+            m_values[position] = m_values[last];
+            m_owners[position] = m_owners[last];
+            m_slots[m_owners[position]].position = position;
+            mark_dirty(position);
+        }
+        m_values.pop_back();
+        m_owners.pop_back();
+        m_is_dirty.pop_back();
+
+        // The handles on the slot are now stale.
+        ++removed.generation;
+        removed.position = m_free;
+        m_free = p_handle.index;
+        return true;
+    }
+
+    /**
+     * @brief Returns true if the handle refers to an element.
+     */
+    bool contains(const gl_slot_handle& p_handle) const
+    {
+        return p_handle.index < m_slots.size()
+            && m_slots[p_handle.index].generation == p_handle.generation
+            && m_slots[p_handle.index].position < m_values.size()
+            && m_owners[m_slots[p_handle.index].position] == p_handle.index;
+    }
+
+    /**
+     * @brief Returns the element of the handle, which must be valid.
+     */
+    const value_type& operator[](const gl_slot_handle& p_handle) const
+    {
+#       ifndef MGL_NDEBUG
+        assert(contains(p_handle));
+#       endif
+        return m_values[m_slots[p_handle.index].position];
+    }
+
+    /**
+     * @brief Returns the element of the handle for modification, it is sent at the next upload.
+     */
+    value_type& modify(const gl_slot_handle& p_handle)
+    {
+#       ifndef MGL_NDEBUG
+        assert(contains(p_handle));
+#       endif
+        const std::uint32_t position = m_slots[p_handle.index].position;
+        mark_dirty(position);
+        return m_values[position];
+    }
+
+    /**
+     * @brief Returns the position of the element in the buffer, valid until the next erase.
+     */
+    size_type position(const gl_slot_handle& p_handle) const
+    {
+#       ifndef MGL_NDEBUG
+        assert(contains(p_handle));
+#       endif
+        return m_slots[p_handle.index].position;
+    }
+
+    /**
+     * @brief Send the elements changed since the last upload to the buffer.
+     * The buffer grows when needed, keeping its content.
+     * @return Returns the number of elements sent.
+     */
+    size_type upload()
+    {
+        size_type sent = 0;
+        // ------------------------- DECLARE ------------------------ //
+
+        if(m_values.size() > m_buffer.size())
+            m_buffer.resize(std::max<size_type>(m_values.size(), 2 * m_buffer.size()));
+
+        // One update per range of consecutive elements.
+        std::sort(m_dirty.begin(), m_dirty.end());
+        for(size_type i = 0; i < m_dirty.size(); )
+        {
+            const std::uint32_t first = m_dirty[i];
+            std::uint32_t last = first;
+            while(++i < m_dirty.size() && m_dirty[i] <= last + 1)
+                last = std::max(last, m_dirty[i]);
+            if(first >= m_values.size())
+                break;
+            last = std::min<std::uint32_t>(last, static_cast<std::uint32_t>(m_values.size() - 1));
+            m_buffer.update(first, &m_values[first], last - first + 1);
+            sent += last - first + 1;
+        }
+
+        for(std::uint32_t position : m_dirty)
+            if(position < m_is_dirty.size())
+                m_is_dirty[position] = false;
+        m_dirty.clear();
+        return sent;
+    }
+
+    /**
+     * @brief Release the memory of the removed elements, when less than a quarter is used.
+     * The buffer is reallocated with its content, the vaos follow it.
+     */
+    void compact()
+    {
+        if(m_buffer.empty() || m_values.size() * 4 > m_buffer.size())
+            return;
+
+        m_values.shrink_to_fit();
+        m_owners.shrink_to_fit();
+        m_dirty.shrink_to_fit();
+        m_buffer.resize(m_values.size());
+        m_buffer.shrink_to_fit();
+    }
+
+    /**
+     * @brief Remove all the elements, every handle becomes invalid.
+     */
+    void clear()
+    {
+        while(!m_values.empty())
+            erase(gl_slot_handle{m_owners.back(), m_slots[m_owners.back()].generation});
+    }
+
+    /**
+     * @brief Returns the number of elements, which is the number of instances to draw.
+     */
+    size_type size() const
+    {
+        return m_values.size();
+    }
+
+    bool empty() const
+    {
+        return m_values.empty();
+    }
+
+    /**
+     * @brief Returns the number of elements waiting for the upload.
+     */
+    size_type dirty_count() const
+    {
+        return m_dirty.size();
+    }
+
+    /**
+     * @brief Returns the elements, in the order of the buffer.
+     */
+    const std::vector<value_type>& values() const
+    {
+        return m_values;
+    }
+
+    /**
+     * @brief Let the passed gl_upload_policy choose how upload() sends the ranges, see gl_vector::update.
+     * @param p_policy is the policy, which must outlive the container, or null.
+     */
+    void set_adaptive_upload(gl_upload_policy* p_policy)
+    {
+        m_buffer.set_adaptive_upload(p_policy);
+    }
+
+    /**
+     * @brief Returns the buffer, up to date after upload().
+     */
+    const buffer_type& buffer() const
+    {
+        return m_buffer;
+    }
+
+private:
+
+    struct slot
+    {
+        /** The position of the element in the buffer, or the next free slot. */
+        std::uint32_t   position;
+        /** Incremented when the element is erased. */
+        std::uint32_t   generation;
+    };
+
+    static constexpr std::uint32_t no_slot = std::uint32_t(-1);
+
+    // ================================================================ //
+    // ============================ METHODS =========================== //
+    // ================================================================ //
+
+    void mark_dirty(size_type p_position)
+    {
+        if(m_is_dirty[p_position])
+            return;
+        m_is_dirty[p_position] = true;
+        m_dirty.push_back(static_cast<std::uint32_t>(p_position));
+    }
+
+    // ================================================================ //
+    // ============================= FIELDS =========================== //
+    // ================================================================ //
+
+    /** The elements, as they are in the buffer. */
+    std::vector<value_type>     m_values;
+    /** The slot of each element. */
+    std::vector<std::uint32_t>  m_owners;
+    /** The indirection table of the handles. */
+    std::vector<slot>           m_slots;
+    /** The first free slot, the others are chained through slot::position. */
+    std::uint32_t               m_free;
+    /** The positions changed since the last upload. */
+    std::vector<std::uint32_t>  m_dirty;
+    /** True for the positions in m_dirty. */
+    std::vector<bool>           m_is_dirty;
+    /** The buffer, at least as large as m_values. */
+    buffer_type                 m_buffer;
+};
+
+template<typename T, typename Buff>
+constexpr std::uint32_t gl_slot_vector<T, Buff>::no_slot;
+
+/**
+ * @ingroup attributes
+ * @brief Transform the buffer of a gl_slot_vector into an instanced buffer.
+ * @param p_slots is the container, which must outlive the vao.
+ * @param p_divisor is the number of instances drawn with each element.
+ * @return Returns the buffer inside the gl_instanced wrapper.
+ */
+template<typename T, typename B>
+gl_instanced<gl_vector<T, B>> make_instanced(const gl_slot_vector<T, B>& p_slots, GLuint p_divisor = 1)
+{
+    return make_instanced(p_slots.buffer(), p_divisor);
+}
+
+} /* namespace mgl */
+
+#endif /* GLSLOTVECTOR_HPP_ */
@@ -9,9 +9,15 @@
 #define GLVECTOR_HPP_
 
 #include <vector>
+#include <algorithm>
 #include <iterator>
 #include <queue>
+#include <cstdint>
+#include <type_traits>
 #include "memory/glallocator.hpp"
+#include "memory/glbuffertrack.hpp"
+#include "memory/glstreamcopy.hpp"
+#include "memory/glupload.hpp"
 
 namespace mgl {
 
@@ -112,6 +118,10 @@ public:
     explicit gl_vector()
         : m_gpu_buff_stack()
         , m_mapped(0)
+        , m_generation(0)
+        , m_track()
+        , m_raw_growth(false)
+        , m_upload(Buff::usage)
 #ifndef MGL_NDEBUG
         , m_map_ranged_called(false)
 #endif
@@ -127,10 +137,14 @@ public:
     explicit gl_vector(size_type p_n)
         : m_gpu_buff_stack()
         , m_mapped(0)
+        , m_generation(0)
+        , m_track()
+        , m_raw_growth(false)
+        , m_upload(Buff::usage)
 #ifndef MGL_NDEBUG
         , m_map_ranged_called(false)
 #endif
-        , m_vector(p_n)
+        , m_vector(p_n, allocator_type(this))
     {
         unmap_pointer();
     }
@@ -146,6 +160,10 @@ public:
     gl_vector(size_type p_n, const value_type& p_value)
         : m_gpu_buff_stack()
         , m_mapped(0)
+        , m_generation(0)
+        , m_track()
+        , m_raw_growth(false)
+        , m_upload(Buff::usage)
 #ifndef MGL_NDEBUG
         , m_map_ranged_called(false)
 #endif
@@ -158,6 +176,10 @@ public:
     gl_vector(InputIt p_first, InputIt p_last)
         : m_gpu_buff_stack()
         , m_mapped(0)
+        , m_generation(0)
+        , m_track()
+        , m_raw_growth(false)
+        , m_upload(Buff::usage)
 #ifndef MGL_NDEBUG
         , m_map_ranged_called(false)
 #endif
@@ -169,6 +191,10 @@ public:
     gl_vector(const gl_vector& p_rhs)
         : m_gpu_buff_stack()
         , m_mapped(0)
+        , m_generation(0)
+        , m_track()
+        , m_raw_growth(false)
+        , m_upload(p_rhs.m_upload)
 #ifndef MGL_NDEBUG
         , m_map_ranged_called(false)
 #endif
@@ -182,15 +208,27 @@ public:
     gl_vector(gl_vector && p_rhs)
         : m_gpu_buff_stack(std::move(p_rhs.m_gpu_buff_stack))
         , m_mapped(std::move(p_rhs.m_mapped))
+        , m_generation(p_rhs.m_generation)
+        , m_track(std::move(p_rhs.m_track))
+        , m_raw_growth(false)
+        , m_upload(p_rhs.m_upload)
 #ifndef MGL_NDEBUG
         , m_map_ranged_called(std::move(m_map_ranged_called))
 #endif
         , m_vector(std::move(p_rhs.m_vector), allocator_type(this))
-    {}
+    {
+        // The vaos follow the vector to its new address.
+        if(m_track)
+            m_track->owner = this;
+    }
 
     gl_vector(std::initializer_list<value_type> p_l)
         : m_gpu_buff_stack()//{0, nullptr}
         , m_mapped(0)
+        , m_generation(0)
+        , m_track()
+        , m_raw_growth(false)
+        , m_upload(Buff::usage)
 #ifndef MGL_NDEBUG
         , m_map_ranged_called(false)
 #endif
@@ -205,6 +243,8 @@ public:
         // the destructors on the elements and deallocate with the allocator
         // which do the unbind plus the deletion of the buffer.
         clear();
+        if(m_track)
+            m_track->owner = nullptr;
         if(!m_gpu_buff_stack.empty()) {
 			gl_object_buffer<Buff>::gl_delete(1, id_ptr());
         }
@@ -230,6 +270,61 @@ public:
         gl_object_buffer<Buff>::gl_bind(0);
     }
 
+    /**
+     * @brief Bind the underlying buffer to an indexed binding point.
+     *
+     * This is how the vector is exposed to shaders, as a shader storage buffer for instance:
+     *  @code
+     *      // layout(std430, binding = 2) buffer Instances { instance instances[]; };
+     *      instances.bind_base(GL_SHADER_STORAGE_BUFFER, 2);
+     *  @endcode
+     * @param p_target is the indexed target.
+     * @param p_index is the binding point.
+     */
+    void bind_base(GLenum p_target, GLuint p_index) const
+    {
+        gl_object_buffer<Buff>::gl_bind_base(p_target, p_index, current_address().id);
+    }
+
+    /**
+     * @brief Returns the name of the underlying OpenGL buffer.
+     * @return Returns the buffer id, 0 if nothing has been allocated yet.
+     */
+    GLuint id() const
+    {
+        return m_gpu_buff_stack.empty() ? 0 : current_address().id;
+    }
+
+    /**
+     * @brief Returns the generation of the underlying OpenGL buffer.
+     *
+     * The generation is incremented each time the vector moves its content to a new
+     * OpenGL buffer (when growing past its capacity for instance), so that the users
+     * of id() know they must fetch it again.
+     */
+    std::uint32_t generation() const
+    {
+        return m_generation;
+    }
+
+    /**
+     * @brief Returns the state shared with the vaos made from this vector.
+     *
+     * Created on the first call. It follows the vector when it is moved and is reset
+     * when the vector is destroyed, see priv::gl_buffer_track.
+     */
+    priv::gl_buffer_track_ptr track() const
+    {
+        if(!m_track)
+        {
+            m_track = std::make_shared<priv::gl_buffer_track>(priv::gl_buffer_track{this,
+                [](const void* p_owner) { return static_cast<const gl_vector*>(p_owner)->id();         },
+                [](const void* p_owner) { return static_cast<const gl_vector*>(p_owner)->generation(); },
+                [](const void* p_owner) { return static_cast<const gl_vector*>(p_owner)->size() * sizeof(T); }});
+        }
+        return m_track;
+    }
+
     /**
      * @brief This function allows to know the OpenGL mapping state of this buffer.
      * @return Return true if the vector is mapped.
@@ -253,8 +348,18 @@ public:
     gl_vector&
     operator=(gl_vector&& p_rhs)
     {
+        if(this == &p_rhs)
+            return *this;
+        // The vaos of the previous buffer see an empty buffer, the ones of p_rhs follow it here.
+        if(m_track)
+            m_track->owner = nullptr;
+        m_track         = std::move(p_rhs.m_track);
+        if(m_track)
+            m_track->owner = this;
         m_gpu_buff_stack  = std::move(p_rhs.m_gpu_buff_stack);
         m_mapped        = std::move(p_rhs.m_mapped);
+        m_generation    = p_rhs.m_generation;
+        m_upload        = p_rhs.m_upload;
 #ifndef MGL_NDEBUG
         m_map_ranged_called = std::move(p_rhs.m_map_ranged_called);
 #endif
@@ -293,6 +398,137 @@ public:
         unmap();
     }
 
+    /**
+     * @brief Append p_n elements at the end, copied at once.
+     *
+     * Unlike insert, the new elements aren't initialized before the copy, and large copies
+     * use non-temporal stores (see priv::stream_copy). The capacity at least doubles when
+     * it isn't enough. The vector doesn't need to be mapped.
+     * @param p_data is the first element to copy, it must not point into the vector.
+     * @param p_n is the number of elements.
+     */
+    void append(const value_type* p_data, size_type p_n)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "append copies bytes, T must be trivially copyable.");
+        const size_type old_size = m_vector.size();
+        // ------------------------- DECLARE ------------------------ //
+
+        if(!p_n)
+            return;
+        if(old_size + p_n > m_vector.capacity())
+            reserve(std::max(old_size + p_n, 2 * m_vector.capacity()));
+
+        map();
+        m_raw_growth = true;
+        m_vector.resize(old_size + p_n);
+        m_raw_growth = false;
+        priv::stream_copy_n(m_vector.data() + old_size, p_data, p_n);
+        unmap();
+    }
+
+    /**
+     * @brief Overwrite p_n elements starting at p_offset, copied at once.
+     *
+     * Large copies use non-temporal stores (see priv::stream_copy).
+     * The vector doesn't need to be mapped.
+     * @param p_offset is the index of the first element to overwrite.
+     * @param p_data is the first element to copy, it must not point into the vector.
+     * @param p_n is the number of elements, p_offset + p_n must not exceed size().
+     */
+    void write(size_type p_offset, const value_type* p_data, size_type p_n)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "write copies bytes, T must be trivially copyable.");
+#       ifndef MGL_NDEBUG
+        assert(p_offset + p_n <= m_vector.size());
+#       endif
+        if(!p_n)
+            return;
+        map();
+        priv::stream_copy_n(m_vector.data() + p_offset, p_data, p_n);
+        unmap();
+    }
+
+    /**
+     * @brief Overwrite p_n elements starting at p_offset, through the update path of the vector.
+     *
+     * The update path is glBufferSubData, unless the vector is adaptive (see set_adaptive_upload).
+     * While the vector is mapped, the elements are copied to the mapped memory instead.
+     * @param p_offset is the index of the first element to overwrite.
+     * @param p_data is the first element to copy, it must not point into the vector.
+     * @param p_n is the number of elements, p_offset + p_n must not exceed size().
+     */
+    void update(size_type p_offset, const value_type* p_data, size_type p_n)
+    {
+#       ifndef MGL_NDEBUG
+        assert(p_offset + p_n <= m_vector.size());
+#       endif
+        if(!p_n)
+            return;
+        if(m_mapped)
+        {
+            write(p_offset, p_data, p_n);
+            return;
+        }
+
+        if(!m_upload.policy)
+        {
+            gl_object_buffer<Buff>::gl_buffer_sub_data(id(), p_offset * sizeof(T), p_n * sizeof(T), p_data);
+            return;
+        }
+
+        gl_upload_policy& policy = *m_upload.policy;
+        const bool whole = p_offset == 0 && p_n == m_vector.size();
+        upload_strategy strategy;
+        // ------------------------- DECLARE ------------------------ //
+
+        policy.record(m_upload, id(), p_n * sizeof(T), whole);
+        strategy = m_upload.strategy;
+        // Orphaning discards the content, it also applies a new usage hint.
+        if(whole && m_upload.usage_pending)
+            strategy = upload_strategy::orphan;
+        else if(!whole && strategy == upload_strategy::orphan)
+            strategy = upload_strategy::sub_data;
+        policy.upload<Buff>(strategy, id(), m_vector.capacity() * sizeof(T), m_upload.usage,
+                            p_offset * sizeof(T), p_n * sizeof(T), p_data);
+        if(strategy == upload_strategy::orphan)
+            m_upload.usage_pending = false;
+    }
+
+    /**
+     * @brief Let the passed gl_upload_policy choose the update path and the usage hint of the
+     * buffer, from the updates made with update().
+     * A new usage hint is applied at the next whole update or the next reallocation.
+     * @param p_policy is the policy, which must outlive the vector, or null to stop the adaptive mode.
+     */
+    void set_adaptive_upload(gl_upload_policy* p_policy)
+    {
+        m_upload.policy = p_policy;
+    }
+
+    /**
+     * @brief Returns the policy of the vector, null if it isn't adaptive.
+     */
+    gl_upload_policy* upload_policy() const
+    {
+        return m_upload.policy;
+    }
+
+    /**
+     * @brief Returns the update path of update().
+     */
+    upload_strategy upload_path() const
+    {
+        return m_upload.strategy;
+    }
+
+    /**
+     * @brief Returns the usage hint of the buffer, Buff::usage unless the vector is adaptive.
+     */
+    GLenum usage() const
+    {
+        return m_upload.usage;
+    }
+
     allocator_type get_allocator() const
     {
         return m_vector.get_allocator();
@@ -370,11 +606,25 @@ public:
     bool
     empty() const           { return m_vector.empty();      }
 
+    /**
+     * @brief Make room for p_n elements, in a new buffer when the capacity isn't enough.
+     *
+     * The vector is mapped during the reallocation, to copy the elements from the old buffer,
+     * thus it doesn't need to be mapped by the caller. Before, the elements were read from the
+     * unmapped buffer, and were lost, unless the caller had mapped the vector. The pointers and
+     * iterators to the elements are invalidated by a reallocation.
+     * @param p_n is the number of elements.
+     */
     void
     reserve(size_type p_n)
     {
+        // Nothing is allocated, thus nothing mapped, when the capacity is already enough.
+        if(p_n <= m_vector.capacity())
+            return;
+        // The elements are copied from the old buffer, which must be mapped too.
+        map();
         m_vector.reserve(p_n);
-        unmap_pointer();
+        unmap();
     }
 
     const base_vector_type&
@@ -620,6 +870,7 @@ private:
     template<typename, typename> friend class gl_vector_iterator;
     template<typename> friend class gl_scope;
     template<typename, typename> friend class gl_vector;
+    template<typename, typename> friend class gl_chunked_vector;
     friend allocator_type;
 
     // ================================================================ //
@@ -636,7 +887,6 @@ private:
 #endif
         if(!m_gpu_buff_stack.empty() && !m_mapped)
         {
-            bind();
             //auto len = max(m_vector.capacity(), 1);
             map_pointer_range(0, m_vector.capacity());
         }
@@ -654,15 +904,14 @@ private:
         --m_mapped;
         if(!m_gpu_buff_stack.empty() && m_mapped == 0)
         {
-            bind();
             unmap_pointer();
         }
     }
 
     /**
      * \brief Map the pointer to be a valid pointer.
-     * Careful ! When using this function, the user should take care of saving
-     * any previously bound Buffer, and bound the buffer hold by this gl_ptr.
+     * Careful ! Without direct state access, the buffer is bound to Buff::target,
+     * the user should take care of saving any previously bound Buffer.
      * Furthermore, if p_length + p_offset is superior to the size of the buffer
      * then error will rise.
      * \param p_offset is the offset for the range.
@@ -674,7 +923,8 @@ private:
         // We make the assumption than the buffer content isn't used in draw call, that's why we have the GL_MAP_UNSYNCHRONIZED_BIT flag
         // And finally, because of the static_assert, the cast can't fail.
         current_address().ptr = reinterpret_cast<T*>(
-                gl_object_buffer<Buff>::gl_map_range(p_offset * sizeof(T),
+                gl_object_buffer<Buff>::gl_map_range(current_address().id,
+                                                     p_offset * sizeof(T),
                                                      p_length * sizeof(T),
                                                      GL_MAP_WRITE_BIT | GL_MAP_READ_BIT/*| GL_MAP_UNSYNCHRONIZED_BIT*/));
 #ifndef MGL_NDEBUG
@@ -685,9 +935,8 @@ private:
 
     /**
      * \brief Unmap the underlying buffer.
-     * Careful ! The buffer isn't manually bound here. This function
-     * made the assumption than the user has done it with bind(), and
-     * has saved any previously bound buffers.
+     * Careful ! Without direct state access, the buffer is bound to Buff::target,
+     * the user should take care of saving any previously bound Buffer.
      */
     void unmap_pointer() const
     {
@@ -695,7 +944,10 @@ private:
         assert(m_map_ranged_called);
         m_map_ranged_called = false;
 #endif
-        assert(gl_object_buffer<Buff>::gl_unmap());
+        // Not inside the assert, the unmap must happen with NDEBUG too.
+        GLboolean unmapped = gl_object_buffer<Buff>::gl_unmap(current_address().id);
+        assert(unmapped);
+        (void)unmapped;
         glCheck(current_address().ptr = nullptr);
     }
 
@@ -716,11 +968,6 @@ private:
         return &current_address().id;
     }
 
-    inline GLuint id() const
-    {
-        return current_address().id;
-    }
-
     inline void reset_id()
     {
         current_address().id = 0;
@@ -739,6 +986,7 @@ private:
     inline void push_address()
     {
         m_gpu_buff_stack.push({0, nullptr});
+        ++m_generation;
     }
 
     inline gpu_buffer<T> pop_address()
@@ -756,6 +1004,14 @@ private:
     mutable std::queue<gpu_buffer<T>>   m_gpu_buff_stack;
     /** the mapping state. */
     mutable unsigned int                m_mapped;
+    /** Incremented each time a new OpenGL buffer is allocated. */
+    std::uint32_t                       m_generation;
+    /** The state shared with the vaos, null until a vao is made from the vector. */
+    mutable priv::gl_buffer_track_ptr   m_track;
+    /** True while append() grows the vector, the allocator then leaves the new elements uninitialized. */
+    bool                                m_raw_growth;
+    /** The update path and the usage hint, see update(). */
+    gl_upload_stats                     m_upload;
 #ifndef MGL_NDEBUG
     mutable bool                        m_map_ranged_called;
 #endif
@@ -8,6 +8,8 @@
 #ifndef GLALLOCATOR_HPP_
 #define GLALLOCATOR_HPP_
 
+#include <new>
+#include <utility>
 #include "glptr.hpp"
 
 namespace mgl {
@@ -108,8 +110,9 @@ public:
         m_owner->push_address();
         gl_object_buffer<Buff>::gl_gen(1, &(m_owner->current_address().id));
 
-        gl_object_buffer<Buff>::gl_bind(m_owner->id());
-        gl_object_buffer<Buff>::gl_buffer_data(p_n * sizeof(T), nullptr);
+        // The usage hint of the owner, which may have been changed by its gl_upload_policy.
+        gl_object_buffer<Buff>::gl_buffer_data(m_owner->id(), p_n * sizeof(T), nullptr, m_owner->m_upload.usage);
+        m_owner->m_upload.usage_pending = false;
         m_owner->map_pointer_range(0, p_n);
         _ret.set_base_address(&(m_owner->current_address()));
 
@@ -134,6 +137,29 @@ public:
         p_ptr.m_ptr = nullptr;
     }
 
+    /**
+     * @brief Value-initialize a new element, unless the owner writes the new elements itself
+     * (see gl_vector::append): then the mapped memory isn't written twice.
+     * @param p_ptr is the address of the element.
+     */
+    template<typename U>
+    void construct(U* p_ptr)
+    {
+        if(m_owner->m_raw_growth)
+            ::new(static_cast<void*>(p_ptr)) U;
+        else
+            ::new(static_cast<void*>(p_ptr)) U();
+    }
+
+    /**
+     * @brief Construct an element from the passed arguments.
+     */
+    template<typename U, typename... Args>
+    void construct(U* p_ptr, Args&&... p_args)
+    {
+        ::new(static_cast<void*>(p_ptr)) U(std::forward<Args>(p_args)...);
+    }
+
     size_type max_size() const
     {
         return size_t(-1) / sizeof(T);
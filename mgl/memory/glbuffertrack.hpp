@@ -0,0 +1,42 @@
+/*
+ * glbuffertrack.hpp
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: nemikolh
+ */
+
+#ifndef GLBUFFERTRACK_HPP_
+#define GLBUFFERTRACK_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace mgl {
+namespace priv {
+
+/**
+ * @brief What the vaos follow of a buffer they are attached to.
+ *
+ * The state is owned by the buffer, created the first time a vao is made from it, and shared
+ * with the vaos. They never hold the buffer itself: the buffer updates owner when it moves
+ * and resets it when it is destroyed, after which the vaos see an empty buffer.
+ */
+struct gl_buffer_track
+{
+    /** The object owning the OpenGL buffer, null once destroyed. */
+    const void*     owner;
+    /** Returns the name of the OpenGL buffer of owner. */
+    GLuint        (*id)(const void*);
+    /** Returns the generation of owner, incremented each time the OpenGL buffer changes. */
+    std::uint32_t (*generation)(const void*);
+    /** Returns the number of bytes in use in the OpenGL buffer of owner. */
+    std::size_t   (*bytes)(const void*);
+};
+
+typedef std::shared_ptr<gl_buffer_track> gl_buffer_track_ptr;
+
+}  /* namespace priv */
+}  /* namespace mgl */
+
+#endif /* GLBUFFERTRACK_HPP_ */
@@ -0,0 +1,537 @@
+/*
+ * glframeallocator.hpp
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: nemikolh
+ */
+
+#ifndef GLFRAMEALLOCATOR_HPP_
+#define GLFRAMEALLOCATOR_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <cassert>
+#include "../type/gltraits.hpp"
+#include "../glexceptions.hpp"
+#include "glstreamcopy.hpp"
+#include "glbuffertrack.hpp"
+
+namespace mgl {
+
+/**
+ * @brief What an allocation of a gl_frame_allocator is used for, which sets its alignment.
+ */
+enum class gl_frame_use
+{
+    /** Vertex attributes, aligned on the size of the element. */
+    vertex,
+    /** Indices, aligned on the size of the index. */
+    index,
+    /** Uniform block, aligned on GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT. */
+    uniform,
+    /** Shader storage block, aligned on GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT. */
+    storage
+};
+
+/**
+ * @brief An allocation of a gl_frame_allocator, valid until the end of the frame.
+ *
+ * The elements are written through pointer, the GPU reads them from buffer at offset.
+ */
+template<typename T>
+struct gl_frame_slice
+{
+    /** The buffer of the allocator. */
+    GLuint      buffer;
+    /** The offset of the first element in the buffer, in bytes. */
+    GLintptr    offset;
+    /** The first element, in the mapped buffer. */
+    T*          pointer;
+    /** The number of elements. */
+    std::size_t count;
+
+    /**
+     * @brief Returns the index of the first element in the buffer seen as an array of T,
+     * see gl_frame_allocator::view. Only for the vertex and index allocations.
+     */
+    std::size_t first() const
+    {
+#       ifndef MGL_NDEBUG
+        assert(offset % sizeof(T) == 0);
+#       endif
+        return offset / sizeof(T);
+    }
+
+    std::size_t size() const        { return count;                 }
+
+    T* begin() const                { return pointer;               }
+
+    T* end() const                  { return pointer + count;       }
+
+    T& operator[](std::size_t p_n) const
+    {
+#       ifndef MGL_NDEBUG
+        assert(p_n < count);
+#       endif
+        return pointer[p_n];
+    }
+
+    /**
+     * @brief Bind the slice to an indexed binding point, as a uniform or a storage block.
+     * @param p_target is the indexed target, GL_UNIFORM_BUFFER for instance.
+     * @param p_index is the binding point.
+     */
+    void bind_range(GLenum p_target, GLuint p_index) const
+    {
+        gl_object_buffer<gl_buffer_type<T>>::gl_bind_range(p_target, p_index, buffer, offset, count * sizeof(T));
+    }
+};
+
+/**
+ * @brief The buffer of a gl_frame_allocator seen as an array of T, to build a gl_vao once.
+ *
+ * The buffer never moves, the vao stays valid for the lifetime of the allocator. The slices
+ * are then drawn with their first() element:
+ *  @code
+ *      mgl::gl_vao vao = mgl::make_vao(frame.view<vertex>(), frame.view<std::uint16_t>());
+ *      ...
+ *      auto vertices = frame.allocate<vertex>(4);
+ *      auto indices  = frame.allocate<std::uint16_t>(6, mgl::gl_frame_use::index);
+ *      ...
+ *      mgl::gl_draw(vao, mgl::gl_draw_range(GL_TRIANGLES, indices.first(), 6)
+ *                            .with_base_vertex(vertices.first()));
+ *  @endcode
+ */
+template<typename T>
+class gl_frame_view
+{
+public:
+    typedef T value_type;
+
+    gl_frame_view(GLuint p_id, std::size_t p_size, priv::gl_buffer_track_ptr p_track)
+        : m_id(p_id)
+        , m_size(p_size)
+        , m_track(std::move(p_track))
+    {}
+
+    void bind() const
+    {
+        gl_object_buffer<gl_buffer_type<T>>::gl_bind(m_id);
+    }
+
+    gl_types::uid id() const
+    {
+        return m_id;
+    }
+
+    /**
+     * @brief Returns the number of T in the whole buffer.
+     */
+    std::size_t size() const
+    {
+        return m_size;
+    }
+
+    /**
+     * @brief Returns the state of the buffer shared with the vaos.
+     */
+    priv::gl_buffer_track_ptr track() const
+    {
+        return m_track;
+    }
+
+private:
+    GLuint                      m_id;
+    std::size_t                 m_size;
+    priv::gl_buffer_track_ptr   m_track;
+};
+
+/**
+ * @brief gl_frame_allocator hands out the transient GPU data of a frame from a single buffer.
+ *
+ * The per frame data, UI quads, debug lines, particles or per draw uniforms, are bump allocated
+ * in the region of the current frame instead of living in short-lived gl_vectors, which would
+ * create and delete OpenGL buffers every frame. The buffer holds p_frames regions used in turn.
+ * A fence is inserted at the end of each frame, the region is only reused once the GPU
+ * is done with it, so that the writes never wait for the draws of the previous frames:
+ *  @code
+ *      mgl::gl_frame_allocator frame(1 << 20);
+ *      ...
+ *      frame.begin_frame();
+ *      auto quads = frame.push(ui_vertices.data(), ui_vertices.size());
+ *      auto block = frame.allocate<camera_block>(1, mgl::gl_frame_use::uniform);
+ *      block[0].view_projection = camera.matrix();
+ *      frame.flush();
+ *      block.bind_range(GL_UNIFORM_BUFFER, 0);
+ *      mgl::gl_draw(ui_format, quads, GL_TRIANGLES);
+ *      frame.end_frame();
+ *  @endcode
+ *
+ * With OpenGL 4.4 or ARB_buffer_storage, the buffer is mapped once, persistently and coherently,
+ * and flush() does nothing. Otherwise the region of the frame is mapped by begin_frame(), without
+ * synchronization since the fence has been waited, and unmapped by flush(), to call before the
+ * first draw reading the frame data.
+ */
+class gl_frame_allocator
+{
+public:
+
+    // ================================================================ //
+    // =========================== CTOR/DTOR ========================== //
+    // ================================================================ //
+
+    /**
+     * @brief Constructor, create the buffer.
+     * @param p_frame_size is the number of bytes available to each frame.
+     * @param p_frames is the number of frames that can be in flight, 3 is the usual latency.
+     */
+    explicit gl_frame_allocator(std::size_t p_frame_size, unsigned int p_frames = 3)
+        : m_id(0)
+        , m_frame_size(p_frame_size)
+        , m_frames(p_frames)
+        , m_fences(p_frames, nullptr)
+        , m_region(p_frames - 1)
+        , m_head(0)
+        , m_end(0)
+        , m_mapped(nullptr)
+        , m_mapped_offset(0)
+        , m_in_frame(false)
+        , m_persistent(priv::has_buffer_storage())
+        , m_stalls(0)
+        , m_track()
+        , m_uniform_alignment(0)
+        , m_storage_alignment(0)
+    {
+        const GLsizeiptr size = m_frame_size * m_frames;
+        GLint alignment = 0;
+        // ------------------------- DECLARE ------------------------ //
+
+        assert(p_frames > 0 && p_frame_size > 0);
+        glCheck(glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment));
+        m_uniform_alignment = alignment > 0 ? alignment : 256;
+        m_storage_alignment = m_uniform_alignment;
+        if(priv::has_compute_shader())
+        {
+            glCheck(glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &alignment));
+            m_storage_alignment = alignment > 0 ? alignment : m_uniform_alignment;
+        }
+
+        gl_object_buffer<frame_buffer>::gl_gen(1, &m_id);
+        if(m_persistent)
+        {
+            const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+            gl_object_buffer<frame_buffer>::gl_buffer_storage(m_id, size, nullptr, flags);
+            m_mapped = static_cast<char*>(gl_object_buffer<frame_buffer>::gl_map_range(m_id, 0, size, flags));
+            if(!m_mapped)
+            {
+                // The destructor isn't called, the buffer is deleted here.
+                gl_object_buffer<frame_buffer>::gl_delete(1, &m_id);
+                m_id = 0;
+                throw gl_out_of_memory();
+            }
+        }
+        else
+            gl_object_buffer<frame_buffer>::gl_buffer_data(m_id, size, nullptr);
+    }
+
+    gl_frame_allocator(const gl_frame_allocator&) = delete;
+    gl_frame_allocator& operator=(const gl_frame_allocator&) = delete;
+
+    /**
+     * @brief Destructor, delete the fences and the buffer, which is unmapped with it.
+     */
+    ~gl_frame_allocator()
+    {
+        if(m_track)
+            m_track->owner = nullptr;
+        for(GLsync fence : m_fences)
+            if(fence)
+                glDeleteSync(fence);
+        if(m_id)
+            gl_object_buffer<frame_buffer>::gl_delete(1, &m_id);
+    }
+
+    // ================================================================ //
+    // ============================ METHODS =========================== //
+    // ================================================================ //
+
+    /**
+     * @brief Start a frame in the next region, once the GPU doesn't read it anymore.
+     * All the slices of the previous frames become invalid.
+     */
+    void begin_frame()
+    {
+#       ifndef MGL_NDEBUG
+        assert(!m_in_frame);
+#       endif
+        m_region = (m_region + 1) % m_frames;
+        wait(m_fences[m_region]);
+        m_fences[m_region] = nullptr;
+
+        m_head     = m_region * m_frame_size;
+        m_end      = m_head + m_frame_size;
+        m_in_frame = true;
+        if(!m_persistent)
+            map_from(m_head);
+    }
+
+    /**
+     * @brief Allocate p_n elements in the region of the frame, aligned for the passed use.
+     * The elements are left uninitialized.
+     * @param p_n is the number of elements.
+     * @param p_use is what the elements are used for.
+     * @return Returns the (buffer, offset, pointer) of the elements, the pointer is null when p_n is 0.
+     * @throw gl_out_of_memory when the region of the frame is full.
+     */
+    template<typename T>
+    gl_frame_slice<T> allocate(std::size_t p_n, gl_frame_use p_use = gl_frame_use::vertex)
+    {
+#       ifndef MGL_NDEBUG
+        assert(m_in_frame);
+#       endif
+        const std::size_t offset = align(m_head, alignment(p_use, alignof(T), sizeof(T)));
+        // ------------------------- DECLARE ------------------------ //
+
+        // Nothing to map, the region may even be full.
+        if(!p_n)
+            return gl_frame_slice<T>{m_id, static_cast<GLintptr>(offset), nullptr, 0};
+        if(offset + p_n * sizeof(T) > m_end)
+            throw gl_out_of_memory();
+        if(!m_mapped)
+            map_from(offset);
+        m_head = offset + p_n * sizeof(T);
+        return gl_frame_slice<T>{m_id, static_cast<GLintptr>(offset),
+                                 reinterpret_cast<T*>(m_mapped + (offset - m_mapped_offset)), p_n};
+    }
+
+    /**
+     * @brief Allocate p_n elements and copy them from p_data.
+     * @see allocate
+     */
+    template<typename T>
+    gl_frame_slice<T> push(const T* p_data, std::size_t p_n, gl_frame_use p_use = gl_frame_use::vertex)
+    {
+        gl_frame_slice<T> slice = allocate<T>(p_n, p_use);
+        // ------------------------- DECLARE ------------------------ //
+
+        priv::stream_copy_n(slice.pointer, p_data, p_n);
+        return slice;
+    }
+
+    /**
+     * @brief Make the writes visible to the GPU, before the first draw using the frame data.
+     * Without persistent mapping, the region is unmapped and the pointers of the slices allocated
+     * so far become invalid. The rest of the region is mapped again by the next allocation.
+     */
+    void flush()
+    {
+        if(m_persistent || !m_mapped)
+            return;
+        GLboolean unmapped = gl_object_buffer<frame_buffer>::gl_unmap(m_id);
+        assert(unmapped);
+        (void)unmapped;
+        m_mapped = nullptr;
+    }
+
+    /**
+     * @brief End the frame, after the last draw using its data.
+     * The region is protected by a fence until the GPU is done with those draws.
+     * @throw gl_context_exception if the fence can't be created.
+     */
+    void end_frame()
+    {
+#       ifndef MGL_NDEBUG
+        assert(m_in_frame);
+#       endif
+        flush();
+        m_in_frame = false;
+        m_fences[m_region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        if(!m_fences[m_region])
+            throw gl_context_exception();
+    }
+
+    /**
+     * @brief Returns the buffer seen as an array of T, to build a vao on it.
+     */
+    template<typename T>
+    gl_frame_view<T> view() const
+    {
+        if(!m_track)
+        {
+            // The buffer never changes, its generation stays 0.
+            m_track = std::make_shared<priv::gl_buffer_track>(priv::gl_buffer_track{this,
+                [](const void* p_owner) { return static_cast<const gl_frame_allocator*>(p_owner)->id(); },
+                [](const void*) { return std::uint32_t(0); },
+                [](const void* p_owner)
+                {
+                    const gl_frame_allocator* owner = static_cast<const gl_frame_allocator*>(p_owner);
+                    return owner->frame_size() * owner->m_frames;
+                }});
+        }
+        return gl_frame_view<T>(m_id, m_frame_size * m_frames / sizeof(T), m_track);
+    }
+
+    /**
+     * @brief Returns the buffer id.
+     */
+    gl_types::uid id() const
+    {
+        return m_id;
+    }
+
+    /**
+     * @brief Returns the number of bytes available to each frame.
+     */
+    std::size_t frame_size() const
+    {
+        return m_frame_size;
+    }
+
+    /**
+     * @brief Returns the number of bytes allocated in the current frame, padding included.
+     */
+    std::size_t used() const
+    {
+        return m_in_frame ? m_head - m_region * m_frame_size : 0;
+    }
+
+    /**
+     * @brief Returns true if the buffer is persistently mapped.
+     */
+    bool persistent() const
+    {
+        return m_persistent;
+    }
+
+    /**
+     * @brief Returns the number of begin_frame() that had to wait for the GPU.
+     * A growing count means that more frames should be in flight.
+     */
+    std::size_t stalls() const
+    {
+        return m_stalls;
+    }
+
+private:
+
+    // ================================================================ //
+    // ============================= TYPES ============================ //
+    // ================================================================ //
+
+    struct frame_buffer
+    {
+        static constexpr GLenum target = GL_ARRAY_BUFFER;
+        static constexpr GLenum usage  = GL_STREAM_DRAW;
+    };
+
+    // ================================================================ //
+    // ======================== STATIC METHODS ======================== //
+    // ================================================================ //
+
+    static std::size_t align(std::size_t p_offset, std::size_t p_alignment)
+    {
+        return (p_offset + p_alignment - 1) / p_alignment * p_alignment;
+    }
+
+    // ================================================================ //
+    // ============================ METHODS =========================== //
+    // ================================================================ //
+
+    std::size_t alignment(gl_frame_use p_use, std::size_t p_align, std::size_t p_size) const
+    {
+        std::size_t a = p_size, b = 4;
+        // ------------------------- DECLARE ------------------------ //
+
+        switch(p_use)
+        {
+        case gl_frame_use::uniform:
+            return std::max<std::size_t>(m_uniform_alignment, p_align);
+        case gl_frame_use::storage:
+            return std::max<std::size_t>(m_storage_alignment, p_align);
+        case gl_frame_use::index:
+            return p_size;
+        case gl_frame_use::vertex:
+            break;
+        }
+        // A multiple of the element size, for first(), and of 4 bytes.
+        while(b)
+        {
+            std::size_t r = a % b;
+            a = b;
+            b = r;
+        }
+        return p_size / a * 4;
+    }
+
+    void wait(GLsync p_fence)
+    {
+        if(!p_fence)
+            return;
+        GLenum status = glClientWaitSync(p_fence, 0, 0);
+        if(status == GL_TIMEOUT_EXPIRED)
+        {
+            ++m_stalls;
+            do
+                status = glClientWaitSync(p_fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+            while(status == GL_TIMEOUT_EXPIRED);
+        }
+        glDeleteSync(p_fence);
+        if(status == GL_WAIT_FAILED)
+            throw gl_context_exception();
+    }
+
+    // Map the rest of the region, without synchronization: the fence of the region has been waited.
+    void map_from(std::size_t p_offset)
+    {
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT;
+        // ------------------------- DECLARE ------------------------ //
+
+        if(p_offset == m_end)
+            return;
+        m_mapped = static_cast<char*>(gl_object_buffer<frame_buffer>::gl_map_range(m_id, p_offset, m_end - p_offset, flags));
+        m_mapped_offset = p_offset;
+        if(!m_mapped)
+            throw gl_out_of_memory();
+    }
+
+    // ================================================================ //
+    // ============================= FIELDS =========================== //
+    // ================================================================ //
+
+    /** The buffer. */
+    GLuint                  m_id;
+    /** The number of bytes of each region. */
+    std::size_t             m_frame_size;
+    /** The number of regions. */
+    unsigned int            m_frames;
+    /** The fence of each region, null when the GPU is done with it. */
+    std::vector<GLsync>     m_fences;
+    /** The region of the current frame. */
+    unsigned int            m_region;
+    /** The next free byte, in the buffer. */
+    std::size_t             m_head;
+    /** The end of the region, in the buffer. */
+    std::size_t             m_end;
+    /** The mapped memory, null when unmapped. */
+    char*                   m_mapped;
+    /** The offset in the buffer of m_mapped. */
+    std::size_t             m_mapped_offset;
+    /** True between begin_frame() and end_frame(). */
+    bool                    m_in_frame;
+    /** True if the buffer is persistently mapped. */
+    bool                    m_persistent;
+    /** The number of waits on the fences. */
+    std::size_t             m_stalls;
+    /** The state shared with the vaos, null until a view is made. */
+    mutable priv::gl_buffer_track_ptr m_track;
+    /** GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT. */
+    std::size_t             m_uniform_alignment;
+    /** GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT. */
+    std::size_t             m_storage_alignment;
+};
+
+} /* namespace mgl */
+
+#endif /* GLFRAMEALLOCATOR_HPP_ */
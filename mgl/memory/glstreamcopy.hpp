@@ -0,0 +1,101 @@
+/*
+ * glstreamcopy.hpp
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: nemikolh
+ */
+
+#ifndef GLSTREAMCOPY_HPP_
+#define GLSTREAMCOPY_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if defined(__AVX__)
+#   include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   include <emmintrin.h>
+#   define MGL_STREAM_SSE2
+#endif
+
+namespace mgl {
+namespace priv {
+
+/**
+ * @brief Below this size, a plain memcpy is faster than the streaming stores and their fence.
+ */
+constexpr std::size_t stream_copy_threshold = 64 * 1024;
+
+/**
+ * @brief Copy p_size bytes to memory written by the GPU only, such as a mapped buffer.
+ *
+ * Large copies use non-temporal stores, which don't pollute the caches and always write
+ * whole 64 bytes lines to the write-combining buffers. The destination is first aligned
+ * with a memcpy of the head, the tail is copied with a memcpy too.
+ * Without SSE2 or for small copies, this is a memcpy.
+ * @param p_dst is the destination, it must not overlap p_src.
+ * @param p_src is the source.
+ * @param p_size is the number of bytes to copy.
+ */
+inline void stream_copy(void* p_dst, const void* p_src, std::size_t p_size)
+{
+#if defined(__AVX__) || defined(MGL_STREAM_SSE2)
+    if(p_size >= stream_copy_threshold)
+    {
+        char*       dst = static_cast<char*>(p_dst);
+        const char* src = static_cast<const char*>(p_src);
+        // ------------------------- DECLARE ------------------------ //
+
+        // Align the destination on a cache line.
+        const std::size_t head = (64 - reinterpret_cast<std::uintptr_t>(dst) % 64) % 64;
+        std::memcpy(dst, src, head);
+        dst += head;
+        src += head;
+        p_size -= head;
+
+        for(; p_size >= 64; p_size -= 64, dst += 64, src += 64)
+        {
+#   if defined(__AVX__)
+            const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+            const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 32));
+            _mm256_stream_si256(reinterpret_cast<__m256i*>(dst), a);
+            _mm256_stream_si256(reinterpret_cast<__m256i*>(dst + 32), b);
+#   else
+            const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+            const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 16));
+            const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 32));
+            const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 48));
+            _mm_stream_si128(reinterpret_cast<__m128i*>(dst), a);
+            _mm_stream_si128(reinterpret_cast<__m128i*>(dst + 16), b);
+            _mm_stream_si128(reinterpret_cast<__m128i*>(dst + 32), c);
+            _mm_stream_si128(reinterpret_cast<__m128i*>(dst + 48), d);
+#   endif
+        }
+        // The streaming stores are weakly ordered, they must be visible before the unmap.
+        _mm_sfence();
+        std::memcpy(dst, src, p_size);
+        return;
+    }
+#endif
+    std::memcpy(p_dst, p_src, p_size);
+}
+
+/**
+ * @brief Same as stream_copy, for p_n elements of T, which are copied as bytes.
+ * @param p_dst is the destination, it must not overlap p_src.
+ * @param p_src is the source.
+ * @param p_n is the number of elements to copy.
+ */
+template<typename T>
+inline void stream_copy_n(T* p_dst, const T* p_src, std::size_t p_n)
+{
+    static_assert(std::is_trivially_copyable<T>::value, "The elements are copied as bytes, T must be trivially copyable.");
+    stream_copy(p_dst, p_src, p_n * sizeof(T));
+}
+
+}  /* namespace priv */
+}  /* namespace mgl */
+
+#endif /* GLSTREAMCOPY_HPP_ */
@@ -0,0 +1,438 @@
+/*
+ * glupload.hpp
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: nemikolh
+ */
+
+#ifndef GLUPLOAD_HPP_
+#define GLUPLOAD_HPP_
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../glexceptions.hpp"
+#include "../type/gltraits.hpp"
+#include "glstreamcopy.hpp"
+
+namespace mgl {
+
+/**
+ * @brief The ways of sending data to an existing buffer.
+ */
+enum class upload_strategy
+{
+    /** glMapBufferRange with GL_MAP_INVALIDATE_RANGE_BIT, then a copy. */
+    map,
+    /** glBufferSubData. */
+    sub_data,
+    /** glBufferData with a null pointer, then glBufferSubData. Whole buffer updates only. */
+    orphan,
+    /** glBufferData in a staging buffer, then glCopyBufferSubData on the GPU. */
+    staging
+};
+
+/**
+ * @brief Returns the name of the strategy, for the logs.
+ */
+inline const char* to_string(upload_strategy p_strategy)
+{
+    switch(p_strategy)
+    {
+    case upload_strategy::map:      return "map";
+    case upload_strategy::sub_data: return "sub_data";
+    case upload_strategy::orphan:   return "orphan";
+    case upload_strategy::staging:  return "staging";
+    }
+    return "unknown";
+}
+
+class gl_upload_policy;
+
+/**
+ * @brief Per buffer record of the updates, kept by the buffer and filled by gl_upload_policy.
+ */
+struct gl_upload_stats
+{
+    explicit gl_upload_stats(GLenum p_usage)
+        : policy(nullptr)
+        , strategy(upload_strategy::sub_data)
+        , usage(p_usage)
+        , usage_pending(false)
+        , window_start(0)
+        , updates(0)
+        , whole_updates(0)
+        , bytes(0)
+    {}
+
+    /** The policy the strategy and the usage follow, null when the buffer isn't adaptive. */
+    gl_upload_policy* policy;
+    /** The current update path. */
+    upload_strategy strategy;
+    /** The usage hint of the buffer, applied at the next storage allocation. */
+    GLenum          usage;
+    /** True when usage isn't yet the one of the storage. */
+    bool            usage_pending;
+    /** The frame at which the observation window started. */
+    std::uint64_t   window_start;
+    /** The number of updates in the window. */
+    std::uint32_t   updates;
+    /** The number of updates of the whole content in the window. */
+    std::uint32_t   whole_updates;
+    /** The number of bytes sent in the window. */
+    std::size_t     bytes;
+};
+
+/**
+ * @brief gl_upload_policy chooses how the adaptive buffers are updated.
+ *
+ * Which update path is the fastest depends on the size of the updates, on their frequency and
+ * on the driver. The policy micro-times the strategies once, with calibrate(), for a few sizes.
+ * Each adaptive buffer (see gl_vector::set_adaptive_upload) then reports its updates. At the end
+ * of each observation window, its strategy becomes the fastest one measured for its average
+ * update size, and its usage hint follows the update frequency:
+ *  - GL_STREAM_DRAW  when the whole content is rewritten about every frame,
+ *  - GL_DYNAMIC_DRAW when it is partially updated about every frame,
+ *  - GL_STATIC_DRAW  when it is seldom updated.
+ * Each change can be logged, see set_logger().
+ *
+ * The frames are counted with next_frame(), to call once per frame. Without it, a window ends
+ * after window_updates updates.
+ *
+ * The policy is passed by its owner to each adaptive buffer, which keeps a pointer on it: the
+ * policy must outlive them. It belongs to the context current when it is used, since it owns a
+ * staging buffer, thus it must be destroyed before its context, or release() must be called.
+ * An application with several contexts owns one policy per context.
+ *  @code
+ *      mgl::gl_upload_policy policy;
+ *      policy.calibrate();
+ *      particles.set_adaptive_upload(&policy);
+ *      ...
+ *      // Every frame:
+ *      particles.update(0, positions.data(), positions.size());
+ *      policy.next_frame();
+ *  @endcode
+ */
+class gl_upload_policy
+{
+public:
+
+    // ================================================================ //
+    // ============================= TYPES ============================ //
+    // ================================================================ //
+
+    /** @brief The function receiving the logged decisions. */
+    typedef std::function<void(const std::string&)> logger_type;
+
+    /** Number of frames observed before a decision. */
+    static constexpr std::uint64_t  window_frames  = 16;
+    /** Number of updates observed before a decision, whatever the frames. */
+    static constexpr std::uint32_t  window_updates = 64;
+    /** Number of size classes timed by calibrate(). */
+    static constexpr std::size_t    size_classes   = 4;
+
+    // ================================================================ //
+    // =========================== CTOR/DTOR ========================== //
+    // ================================================================ //
+
+    gl_upload_policy()
+        : m_frame(0)
+        , m_calibrated(false)
+        , m_staging(0)
+        , m_logger(nullptr)
+    {
+        for(std::size_t i = 0; i < size_classes; ++i)
+        {
+            // Before the calibration: glBufferSubData for the small updates,
+            // the orphaning or a mapping for the large ones.
+            m_best_whole[i]   = i < 2 ? upload_strategy::sub_data : upload_strategy::orphan;
+            m_best_partial[i] = i < 2 ? upload_strategy::sub_data : upload_strategy::map;
+        }
+    }
+
+    gl_upload_policy(const gl_upload_policy&) = delete;
+    gl_upload_policy& operator=(const gl_upload_policy&) = delete;
+
+    /**
+     * @brief Delete the staging buffer, the context of the policy must be current.
+     */
+    ~gl_upload_policy()
+    {
+        release();
+    }
+
+    // ================================================================ //
+    // ============================ METHODS =========================== //
+    // ================================================================ //
+
+    /**
+     * @brief Send p_size bytes at p_offset in the buffer p_id, with the passed strategy.
+     *
+     * The buffer must not be mapped. The orphan strategy re-specifies the storage of p_capacity
+     * bytes with p_usage, discarding the content: use it only when the update rewrites all the
+     * content in use.
+     * @param p_strategy is the update path.
+     * @param p_id is the buffer.
+     * @param p_capacity is the size of the storage, in bytes.
+     * @param p_usage is the usage hint for the orphan strategy.
+     * @param p_offset is the offset of the update, in bytes.
+     * @param p_size is the size of the update, in bytes.
+     * @param p_data is the data to send.
+     * @throw gl_out_of_memory if the map strategy can't map the buffer.
+     */
+    template<typename Buff>
+    void upload(upload_strategy p_strategy, GLuint p_id, GLsizeiptr p_capacity, GLenum p_usage,
+                GLintptr p_offset, GLsizeiptr p_size, const GLvoid* p_data)
+    {
+        switch(p_strategy)
+        {
+        case upload_strategy::map:
+        {
+            void* ptr = gl_object_buffer<Buff>::gl_map_range(p_id, p_offset, p_size,
+                                                             GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+            if(!ptr)
+                throw gl_out_of_memory();
+            priv::stream_copy(ptr, p_data, p_size);
+            // The content is undefined when the unmap fails, after a video mode change for instance.
+            if(!gl_object_buffer<Buff>::gl_unmap(p_id))
+                gl_object_buffer<Buff>::gl_buffer_sub_data(p_id, p_offset, p_size, p_data);
+            break;
+        }
+        case upload_strategy::orphan:
+            gl_object_buffer<Buff>::gl_buffer_data(p_id, p_capacity, nullptr, p_usage);
+            gl_object_buffer<Buff>::gl_buffer_sub_data(p_id, p_offset, p_size, p_data);
+            break;
+        case upload_strategy::staging:
+            // Orphan the staging buffer at each copy, the previous copy may still read it.
+            if(!m_staging)
+                gl_object_buffer<staging_buffer>::gl_gen(1, &m_staging);
+            gl_object_buffer<staging_buffer>::gl_buffer_data(m_staging, p_size, p_data);
+            gl_object_buffer<Buff>::gl_copy_sub_data(m_staging, p_id, 0, p_offset, p_size);
+            break;
+        case upload_strategy::sub_data:
+            gl_object_buffer<Buff>::gl_buffer_sub_data(p_id, p_offset, p_size, p_data);
+            break;
+        }
+    }
+
+    /**
+     * @brief Time the strategies for each size class, and keep the fastest ones.
+     * A context must be current. It takes a few tens of milliseconds, at startup.
+     */
+    void calibrate()
+    {
+        static const std::size_t    sizes[size_classes] = { 4 << 10, 64 << 10, 1 << 20, 8 << 20 };
+        static const int            repeats = 8;
+        const upload_strategy       all[] = { upload_strategy::map, upload_strategy::sub_data,
+                                              upload_strategy::orphan, upload_strategy::staging };
+        std::vector<char>           source(sizes[size_classes - 1], 1);
+        GLuint                      scratch = 0;
+        std::ostringstream          message;
+        // ------------------------- DECLARE ------------------------ //
+
+        gl_object_buffer<staging_buffer>::gl_gen(1, &scratch);
+        message << "upload calibration:";
+        for(std::size_t c = 0; c < size_classes; ++c)
+        {
+            const GLsizeiptr    size          = sizes[c];
+            double              best_whole    = 0.;
+            double              best_partial  = 0.;
+            // ------------------------- DECLARE ------------------------ //
+
+            gl_object_buffer<staging_buffer>::gl_buffer_data(scratch, size, nullptr, GL_DYNAMIC_DRAW);
+            message << "\n  " << (size >> 10) << " KB:";
+            for(upload_strategy strategy : all)
+            {
+                // The first upload is a warm up, not timed.
+                upload<staging_buffer>(strategy, scratch, size, GL_DYNAMIC_DRAW, 0, size, source.data());
+                glFinish();
+                const auto start = std::chrono::steady_clock::now();
+                for(int i = 0; i < repeats; ++i)
+                    upload<staging_buffer>(strategy, scratch, size, GL_DYNAMIC_DRAW, 0, size, source.data());
+                glFinish();
+                const std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+                const double time = elapsed.count() / repeats;
+
+                message << ' ' << to_string(strategy) << ' ' << time << "us";
+                if(best_whole == 0. || time < best_whole)
+                {
+                    best_whole = time;
+                    m_best_whole[c] = strategy;
+                }
+                if(strategy != upload_strategy::orphan && (best_partial == 0. || time < best_partial))
+                {
+                    best_partial = time;
+                    m_best_partial[c] = strategy;
+                }
+            }
+            message << " -> " << to_string(m_best_whole[c]) << '/' << to_string(m_best_partial[c]);
+        }
+        gl_object_buffer<staging_buffer>::gl_delete(1, &scratch);
+        m_calibrated = true;
+        log(message.str());
+    }
+
+    /**
+     * @brief Returns true once calibrate() has been called.
+     */
+    bool calibrated() const
+    {
+        return m_calibrated;
+    }
+
+    /**
+     * @brief Returns the fastest strategy for updates of p_size bytes.
+     * @param p_size is the size of the updates.
+     * @param p_whole is true if the updates rewrite the whole content.
+     */
+    upload_strategy best(std::size_t p_size, bool p_whole) const
+    {
+        const std::size_t c = p_size <= (16 << 10) ? 0 : p_size <= (256 << 10) ? 1 : p_size <= (4 << 20) ? 2 : 3;
+        return p_whole ? m_best_whole[c] : m_best_partial[c];
+    }
+
+    /**
+     * @brief Record an update of an adaptive buffer, and revise its strategy and its usage
+     * at the end of the observation window.
+     * @param p_stats is the record of the buffer.
+     * @param p_id is the buffer, for the logs.
+     * @param p_size is the size of the update, in bytes.
+     * @param p_whole is true if the update rewrites the whole content.
+     */
+    void record(gl_upload_stats& p_stats, GLuint p_id, std::size_t p_size, bool p_whole)
+    {
+        if(p_stats.policy != this)
+            return;
+        if(p_stats.updates == 0)
+            p_stats.window_start = m_frame;
+        ++p_stats.updates;
+        p_stats.whole_updates += p_whole;
+        p_stats.bytes += p_size;
+
+        const std::uint64_t frames = m_frame - p_stats.window_start;
+        if(frames < window_frames && p_stats.updates < window_updates)
+            return;
+
+        // ------------------------- DECIDE ------------------------- //
+        const double            per_frame  = double(p_stats.updates) / double(frames ? frames : 1);
+        const std::size_t       average    = p_stats.bytes / p_stats.updates;
+        const bool              whole      = 2 * p_stats.whole_updates > p_stats.updates;
+        const upload_strategy   strategy   = best(average, whole);
+        const GLenum            usage      = per_frame >= 0.5 ? (whole ? GL_STREAM_DRAW : GL_DYNAMIC_DRAW)
+                                           : per_frame * window_frames < 1. ? GL_STATIC_DRAW : GL_DYNAMIC_DRAW;
+
+        if(strategy != p_stats.strategy || usage != p_stats.usage)
+        {
+            std::ostringstream message;
+            message << "buffer " << p_id << ": " << per_frame << " updates/frame of " << average << " bytes"
+                    << (whole ? " (whole)" : "") << ", path ";
+            if(strategy != p_stats.strategy)
+                message << to_string(p_stats.strategy) << " -> ";
+            message << to_string(strategy) << ", usage " << std::hex << std::showbase;
+            if(usage != p_stats.usage)
+                message << p_stats.usage << " -> ";
+            message << usage;
+            log(message.str());
+            p_stats.usage_pending = p_stats.usage_pending || usage != p_stats.usage;
+            p_stats.strategy = strategy;
+            p_stats.usage    = usage;
+        }
+        p_stats.updates       = 0;
+        p_stats.whole_updates = 0;
+        p_stats.bytes         = 0;
+    }
+
+    /**
+     * @brief Count a frame, call it once per frame.
+     */
+    void next_frame()
+    {
+        ++m_frame;
+    }
+
+    /**
+     * @brief Returns the number of frames counted.
+     */
+    std::uint64_t frame() const
+    {
+        return m_frame;
+    }
+
+    /**
+     * @brief Set the function receiving the calibration results and the changes of strategy
+     * and usage of the buffers. There is none by default, nullptr disables the logs again.
+     *  @code
+     *      policy.set_logger([](const std::string& p_message) { std::clog << "mgl: " << p_message << std::endl; });
+     *  @endcode
+     */
+    void set_logger(logger_type p_logger)
+    {
+        m_logger = std::move(p_logger);
+    }
+
+    /**
+     * @brief Returns the current logger.
+     */
+    const logger_type& logger() const
+    {
+        return m_logger;
+    }
+
+    /**
+     * @brief Delete the staging buffer now, when the context is destroyed before the policy.
+     * The calibration is kept, the next staging upload creates a new staging buffer.
+     */
+    void release()
+    {
+        if(m_staging)
+            gl_object_buffer<staging_buffer>::gl_delete(1, &m_staging);
+        m_staging = 0;
+    }
+
+private:
+
+    // ================================================================ //
+    // ============================= TYPES ============================ //
+    // ================================================================ //
+
+    struct staging_buffer
+    {
+        static constexpr GLenum target = GL_COPY_READ_BUFFER;
+        static constexpr GLenum usage  = GL_STREAM_DRAW;
+    };
+
+    // ================================================================ //
+    // ============================ METHODS =========================== //
+    // ================================================================ //
+
+    void log(const std::string& p_message) const
+    {
+        if(m_logger)
+            m_logger(p_message);
+    }
+
+    // ================================================================ //
+    // ============================= FIELDS =========================== //
+    // ================================================================ //
+
+    /** The number of frames counted. */
+    std::uint64_t   m_frame;
+    /** True once calibrate() has been called. */
+    bool            m_calibrated;
+    /** The fastest strategy for whole buffer updates, per size class. */
+    upload_strategy m_best_whole[size_classes];
+    /** The fastest strategy for partial updates, per size class. */
+    upload_strategy m_best_partial[size_classes];
+    /** The staging buffer, created by the first staging upload. */
+    GLuint          m_staging;
+    /** The destination of the logs. */
+    logger_type     m_logger;
+};
+
+} /* namespace mgl */
+
+#endif /* GLUPLOAD_HPP_ */
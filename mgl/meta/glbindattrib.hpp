@@ -9,53 +9,12 @@
 #define GLBINDATTRIB_HPP_
 
 #include "glbinder.hpp"
-#include "gltuplesize.hpp"
+#include "gllayout.hpp"
 #include "../meta/glutil.hpp"
 
 namespace mgl {
 namespace priv {
 
-    /**
-     * Meta function iterating over attributes of the Sequence.
-     */
-    template<typename Seq, typename AttributeBinder, typename N>
-    struct bind_Iter
-    {
-        typedef typename value_at<Seq, N::value>::type     current_t;
-        typedef struct_member_name<Seq, N::value>          name_t;
-
-        static inline void map(const AttributeBinder & sh)
-        {
-            static_assert(tuple_size<current_t>::value < 5,"The tuple size must be either 1, 2, 3 or 4. GL_BGRA is not currently supported.");
-            // ------------------------- DECLARE ------------------------ //
-
-            sh(
-                name_t::call(),                         // attribute name
-                tuple_size<current_t>::value,           // number of component
-                offset_at<Seq, N::value>::value,        // offsetof(Seq, name_t) conceptually
-                sizeof(Seq),                            // stride
-                tuple_component_type<current_t>::value  // deduce
-            );
-
-            bind_Iter<Seq, AttributeBinder, int_<N::value + 1>>::map(sh);
-        }
-    };
-
-    /**
-     * End of iteration.
-     */
-    template<typename Seq, typename AttributeBinder>
-    struct bind_Iter<Seq, AttributeBinder, int_<seq_size<Seq>::value>>
-    {
-        static inline void map(...) {}
-    };
-
-    /**
-     * Start of the iteration.
-     */
-    template<typename Seq, typename AttributeBinder>
-    struct bind_first : bind_Iter<Seq, AttributeBinder, int_<0>> {};
-
     /**
      * External entry for the mapping.
      */
@@ -65,7 +24,12 @@ namespace priv {
         typedef bind_attributes<Seq, AttributeBinder> type;
         static inline void map(const AttributeBinder & sh)
         {
-            bind_first<Seq, AttributeBinder>::map(sh);
+            GLuint shift = 0;
+            // ------------------------- DECLARE ------------------------ //
+
+            // Loop over the table built at compile time, a matrix being bound column by column.
+            for(const gl_attribute_desc& attribute : gl_vertex_layout<Seq>::attributes)
+                sh(bound_attribute(attribute, shift), sizeof(Seq));
         }
     };
 
@@ -92,14 +56,18 @@ namespace priv {
  *
  *      @code
  *          void operator()(
- *              char const*,                        // attribute name
- *              int,                                // number of component
- *              std::size_t,                        // offsetof(Seq, name_t)
- *              std::size_t,                        // stride
- *              GLenum                              // type of the component (GL_FLOAT, ...)
+ *              const gl_attribute_desc&,           // the member, see gl_vertex_layout
+ *              std::size_t                         // stride
  *          );
  *      @endcode
  *
+ *  A matrix member is bound as one attribute per column, at consecutive locations:
+ *
+ *      @code
+ *          MGL_DEFINE_GL_ATTRIBUTES(, instance, (glm::mat4, model)(glm::vec4, color))
+ *          // model takes the locations 0 to 3, color the location 4.
+ *      @endcode
+ *
  *
  * @param T is the structure defined with NKH_DEFINE_GLATTRIBUTES
  */
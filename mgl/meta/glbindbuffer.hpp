@@ -13,9 +13,14 @@
 #include <tuple>
 #include <numeric>
 #include <algorithm>
+#include <limits>
+#include <vector>
+#include <cstdint>
 
 #include "glbindattrib.hpp"
 #include "glinstanced.hpp"
+#include "glsimplebuffer.hpp"
+#include "../glexceptions.hpp"
 
 namespace mgl {
 
@@ -24,17 +29,92 @@ namespace priv {
 template<typename T>
 struct is_gl_attributes;
 
+/**
+ * @brief A buffer attached to a vao, with what is needed to attach it again
+ * when the buffer moves to a new OpenGL buffer.
+ *
+ * Only the state shared with the buffer is kept, see gl_buffer_track, and the attributes
+ * with their resolved locations, thus the binding never refers to the buffer nor to the program.
+ */
+struct vao_binding
+{
+    enum class kind { vertices, elements, instanced };
+
+    /** What the buffer is used for. */
+    kind                        type;
+    /** The state shared with the buffer. */
+    gl_buffer_track_ptr         track;
+    /** The generation of the buffer when it has been attached. */
+    std::uint32_t               bound_generation;
+    /** The attribute divisor, 0 unless the buffer is instanced. */
+    GLuint                      divisor;
+    /** The binding index in the vao, with direct state access. */
+    GLuint                      binding;
+    /** The size of an element of the buffer. */
+    std::size_t                 stride;
+    /** The attributes, without direct state access. */
+    std::vector<vao_attribute>  attributes;
+
+    /**
+     * @brief Returns the current number of elements of the buffer, 0 once destroyed.
+     */
+    std::size_t size() const
+    {
+        return track->owner ? track->bytes(track->owner) / stride : 0;
+    }
+
+    /**
+     * @brief Attach the current OpenGL buffer again, to the passed vao with direct state access
+     * or to the bound vao if 0. Instanced buffers start at the passed base instance.
+     * Does nothing once the buffer has been destroyed.
+     */
+    void attach(gl_types::uid p_vao, std::size_t p_base_instance)
+    {
+        if(!track->owner)
+            return;
+        const GLuint id = track->id(track->owner);
+        const std::size_t offset = type == kind::instanced ? p_base_instance * stride : 0;
+        // ------------------------- DECLARE ------------------------ //
+
+        bound_generation = track->generation(track->owner);
+        if(type == kind::elements)
+        {
+            if(p_vao)
+                gl_object_vertexarrays::gl_element_buffer(p_vao, id);
+            else
+                gl_object_buffer<gl_buffer_target<GL_ELEMENT_ARRAY_BUFFER>>::gl_bind(id);
+        }
+        else if(p_vao)
+            // With direct state access, only the buffer of the binding changes.
+            gl_object_vertexarrays::gl_bind_vertex_buffer(p_vao, binding, id, offset, stride);
+        else
+        {
+            // The vao is bound, set the attributes again on the new buffer.
+            gl_object_buffer<gl_buffer_target<GL_ARRAY_BUFFER>>::gl_bind(id);
+            for(const vao_attribute& a : attributes)
+                gl_object_vertexarrays::gl_attrib_pointer(a.location, a.components, a.type, a.normalized, stride,
+                                                          reinterpret_cast<const GLvoid*>(offset + a.offset));
+        }
+    }
+};
+
 struct bind_buffers_helper
 {
     // ================================================================ //
     // =========================== CTOR/DTOR ========================== //
     // ================================================================ //
 
-    bind_buffers_helper(gl_types::uid p_program_id)
-        : m_program_id{p_program_id}
+    bind_buffers_helper(const gl_attribute_locations* p_locations, gl_types::uid p_vao)
+        : m_locations(p_locations)
+        , m_records(nullptr)
+        , m_attributes()
+        , m_enabled(nullptr)
+        , m_vao(p_vao)
+        , m_binding{0}
         , m_elements_type{0}
         , m_size{0}
         , m_size_instanced{std::numeric_limits<std::size_t>::max()}
+        , m_base_instance{0}
     {}
 
     // ================================================================ //
@@ -46,9 +126,9 @@ struct bind_buffers_helper
     typename std::enable_if<is_gl_attributes<T>::value, void>::type
     bind_buffer(const gl_vector<T, B>& p_buffer)
     {
-        p_buffer.bind();
-        gl_attribute_binder binder(m_program_id);
+        gl_attribute_binder binder = attach(p_buffer, sizeof(T), 0);
         gl_bind_attributes<T>::map(binder);
+        record(vao_binding::kind::vertices, p_buffer, sizeof(T));
     }
 
     // Called only if the type I is integral and not a gl attribute.
@@ -57,23 +137,52 @@ struct bind_buffers_helper
     bind_buffer(const gl_vector<I, B>& p_buffer)
     {
         // Bind the element buffer.
-        p_buffer.bind();
+        if(m_vao)
+            gl_object_vertexarrays::gl_element_buffer(m_vao, p_buffer.id());
+        else
+            p_buffer.bind();
         m_elements_type = gl_enum_from_type<I>::value;
 #ifndef MGL_NDEBUG
         assert(m_size == 0);
 #endif
         m_size = p_buffer.size();
+        record(vao_binding::kind::elements, p_buffer, sizeof(I));
         // TODO : assert to check that the type of the buffer is ELEMENT_ARRAY
         // TODO : check that this function is called only once in NDEBUG mode.
     }
 
+    // Called for the vertices of a gl_frame_allocator.
+    template<typename T>
+    typename std::enable_if<is_gl_attributes<T>::value, void>::type
+    bind_buffer(const gl_frame_view<T>& p_view)
+    {
+        gl_attribute_binder binder = attach(p_view, sizeof(T), 0);
+        gl_bind_attributes<T>::map(binder);
+        record(vao_binding::kind::vertices, p_view, sizeof(T));
+    }
+
+    // Called for the indices of a gl_frame_allocator.
+    template<typename I>
+    typename std::enable_if<std::is_integral<I>::value && !is_gl_attributes<I>::value, void>::type
+    bind_buffer(const gl_frame_view<I>& p_view)
+    {
+        if(m_vao)
+            gl_object_vertexarrays::gl_element_buffer(m_vao, p_view.id());
+        else
+            p_view.bind();
+        m_elements_type = gl_enum_from_type<I>::value;
+        m_size = p_view.size();
+        record(vao_binding::kind::elements, p_view, sizeof(I));
+    }
+
     // Called for simple integers, floating point or glm vectors types buffers.
     template<typename T, typename B>
     void bind_buffer(const gl_simple_buffer<T, B>& p_wrapper)
     {
-        p_wrapper.bind();
-        gl_attribute_binder binder(m_program_id);
-        binder(p_wrapper.attribute_name(), tuple_size<T>::value, 0, sizeof(T), tuple_component_type<T>::value);
+        check_location(p_wrapper);
+        gl_attribute_binder binder = attach(p_wrapper, sizeof(T), 0);
+        binder(p_wrapper.attribute_name(), hash_str(p_wrapper.attribute_name()), p_wrapper.location(), tuple_size<T>::value, 0, sizeof(T), tuple_component_type<T>::value);
+        record(vao_binding::kind::vertices, p_wrapper, sizeof(T));
     }
 
     // Called when the buffer is an instanced buffer.
@@ -81,30 +190,82 @@ struct bind_buffers_helper
     typename std::enable_if<is_gl_attributes<T>::value, void>::type
     bind_buffer(const gl_instanced<gl_vector<T, B>>& p_wrapper)
     {
-        p_wrapper.bind();
-        gl_attribute_binder binder(m_program_id, p_wrapper.get_divisor());
+        gl_attribute_binder binder = attach(p_wrapper, sizeof(T), p_wrapper.get_divisor());
         gl_bind_attributes<T>::map(binder);
-        m_size_instanced = std::min(m_size_instanced, p_wrapper.size());
+        m_size_instanced = std::min(m_size_instanced, p_wrapper.size() * p_wrapper.get_divisor());
+        record(vao_binding::kind::instanced, p_wrapper, sizeof(T), p_wrapper.get_divisor());
     }
 
     // Called for simple buffers.
     template<typename T, typename B>
     void bind_buffer(const gl_instanced<gl_simple_buffer<T, B>>& p_wrapper)
     {
-        p_wrapper.bind();
-        gl_attribute_binder binder(m_program_id);
-        binder(p_wrapper.buffer().attribute_name(), tuple_size<T>::value, 0, sizeof(T), tuple_component_type<T>::value);
-        m_size_instanced = std::min(m_size_instanced, p_wrapper.size());
+        check_location(p_wrapper.buffer());
+        gl_attribute_binder binder = attach(p_wrapper, sizeof(T), p_wrapper.get_divisor());
+        binder(p_wrapper.buffer().attribute_name(), hash_str(p_wrapper.buffer().attribute_name()), p_wrapper.buffer().location(), tuple_size<T>::value, 0, sizeof(T), tuple_component_type<T>::value);
+        m_size_instanced = std::min(m_size_instanced, p_wrapper.size() * p_wrapper.get_divisor());
+        record(vao_binding::kind::instanced, p_wrapper, sizeof(T), p_wrapper.get_divisor());
+    }
+
+    // Without program, a simple buffer has no location unless make_buffer() received one.
+    template<typename T, typename B>
+    void check_location(const gl_simple_buffer<T, B>& p_wrapper) const
+    {
+        if(!m_locations && p_wrapper.location() == -1)
+            throw gl_unknown_location(p_wrapper.attribute_name());
+    }
+
+    // Attach the passed buffer and returns the binder for its attributes.
+    // Without vao, the buffer is just bound for glVertexAttribPointer.
+    // Instanced buffers start at m_base_instance.
+    template<typename V>
+    gl_attribute_binder attach(const V& p_buffer, std::size_t p_stride, GLuint p_divisor)
+    {
+        std::size_t offset = p_divisor ? m_base_instance * p_stride : 0;
+        // ------------------------- DECLARE ------------------------ //
+
+        if(!m_vao)
+        {
+            p_buffer.bind();
+            return gl_attribute_binder(m_locations, p_divisor).track(m_enabled).offset_by(offset)
+                                                               .record_to(m_records ? &m_attributes : nullptr);
+        }
+        GLuint binding = m_binding++;
+        gl_object_vertexarrays::gl_bind_vertex_buffer(m_vao, binding, p_buffer.id(), offset, p_stride);
+        gl_object_vertexarrays::gl_binding_divisor(m_vao, binding, p_divisor);
+        return gl_attribute_binder(m_locations, p_divisor, m_vao, binding).track(m_enabled);
+    }
+
+    // Keep what is needed to attach the buffer again once it has been reallocated.
+    template<typename V>
+    void record(vao_binding::kind p_kind, const V& p_buffer, std::size_t p_stride, GLuint p_divisor = 0)
+    {
+        if(!m_records)
+            return;
+        gl_buffer_track_ptr track = p_buffer.track();
+        // ------------------------- DECLARE ------------------------ //
+
+        m_records->push_back(vao_binding{p_kind, track, track->generation(track->owner), p_divisor,
+                                         m_binding - 1, p_stride, std::move(m_attributes)});
+        m_attributes.clear();
     }
 
     // ================================================================ //
     // ============================= FIELDS =========================== //
     // ================================================================ //
 
-    gl_types::uid m_program_id;
+    const gl_attribute_locations* m_locations;
+    std::vector<vao_binding>*     m_records;
+    /** The attributes of the buffer being attached, moved to its record. */
+    std::vector<vao_attribute>    m_attributes;
+    std::uint32_t*                m_enabled;
+    gl_types::uid m_vao;
+    GLuint       m_binding;
     gl_types::en m_elements_type;
     std::size_t  m_size;
     std::size_t  m_size_instanced;
+    /** First element of the instanced buffers. */
+    std::size_t  m_base_instance;
 };
 
 }  /* namespace priv */
@@ -120,7 +281,7 @@ struct bind_buffers_helper
  *          mgl::gl_vector<int> buffer_instanced;
  *          mgl::gl_vector<glm::vec3> buffer_simple;
  *          // ...
- *          mgl::gl_bind_buffers binder(program_id);
+ *          mgl::gl_bind_buffers binder(program.attribute_locations());
  *          binder.map(buffer_vector, mgl::make_buffer(buffer_simple), mgl::make_instanced(buffer_instanced));
  *          // Now the buffer have been binded.
  *      @endcode
@@ -131,20 +292,64 @@ struct gl_bind_buffers
     // =========================== CTOR/DTOR ========================== //
     // ================================================================ //
 
-    gl_bind_buffers(gl_types::uid p_program_id)
-        : m_program_id(p_program_id)
+    /**
+     * @brief Bind the attributes to the locations of the passed program's table.
+     * @param p_locations is the attribute table of the program.
+     */
+    gl_bind_buffers(const gl_attribute_locations& p_locations)
+        : m_locations(&p_locations)
+        , m_records(nullptr)
+        , m_enabled(nullptr)
+        , m_vao(0)
+    {}
+
+    /**
+     * @brief Bind the attributes to the locations assigned at compile time.
+     * @see attribute_location
+     */
+    gl_bind_buffers()
+        : m_locations(nullptr)
+        , m_records(nullptr)
+        , m_enabled(nullptr)
+        , m_vao(0)
     {}
 
     // ================================================================ //
     // ============================ METHODS =========================== //
     // ================================================================ //
 
+    /**
+     * @brief Edit the passed vao with direct state access instead of the bound one.
+     * Requires OpenGL 4.5 or ARB_direct_state_access.
+     * @param p_vao is the vao receiving the buffers.
+     */
+    gl_bind_buffers& to_vao(gl_types::uid p_vao)
+    {
+        m_vao = p_vao;
+        return *this;
+    }
+
+    /**
+     * @brief Keep a record of each buffer attached, so that it can be attached
+     * again when its OpenGL buffer changes.
+     * @param p_records receives the records.
+     * @param p_enabled receives the mask of the attributes enabled.
+     */
+    gl_bind_buffers& record_to(std::vector<priv::vao_binding>& p_records, std::uint32_t& p_enabled)
+    {
+        m_records = &p_records;
+        m_enabled = &p_enabled;
+        return *this;
+    }
+
     template<typename... T>
     inline
     std::tuple<gl_types::uid, std::size_t, std::size_t> map(T&&... p_buffers)
     {
         //pass(bindBuffer(p_program_id, std::forward<Arg>(p_args))...);
-        priv::bind_buffers_helper helper(m_program_id);
+        priv::bind_buffers_helper helper(m_locations, m_vao);
+        helper.m_records = m_records;
+        helper.m_enabled = m_enabled;
         pass((helper.bind_buffer(std::forward<T>(p_buffers)), 1)...);
         return std::make_tuple(helper.m_elements_type, helper.m_size, helper.m_size_instanced);
     }
@@ -159,7 +364,10 @@ private:
     // ============================= FIELDS =========================== //
     // ================================================================ //
 
-    gl_types::uid m_program_id;
+    const gl_attribute_locations*   m_locations;
+    std::vector<priv::vao_binding>* m_records;
+    std::uint32_t*                  m_enabled;
+    gl_types::uid                   m_vao;
 };
 
 }  /* namespace mgl */
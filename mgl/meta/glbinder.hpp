@@ -8,10 +8,29 @@
 #ifndef GLBINDER_HPP_
 #define GLBINDER_HPP_
 
+#include <vector>
 #include "../type/gltraits.hpp"
+#include "../type/glattributelocations.hpp"
+#include "gllayout.hpp"
 
 namespace mgl {
 
+namespace priv {
+
+/**
+ * @brief An attribute set by glVertexAttribPointer, kept to set it again on another buffer.
+ */
+struct vao_attribute
+{
+    GLint       location;
+    GLint       components;
+    GLenum      type;
+    GLboolean   normalized;
+    std::size_t offset;
+};
+
+}  /* namespace priv */
+
 /**
  * @ingroup attributes
  * @brief gl_attribute_binder is a functor that encapsulate the OpenGL call binding
@@ -26,30 +45,43 @@ struct gl_attribute_binder
     /**
      * Bind the passed attribute.
      * @param p_attribute_name is the name of the attribute to bind.
+     * @param p_name_hash is the hash of p_attribute_name.
+     * @param p_location is the location assigned at compile time, or -1 if none.
      * @param p_nb_component is the number of component  for the attribute.
      * @param p_offset is the offset where the attribute start in the buffer.
      * @param p_stride is the stride between two consecutives values.
      * @param p_component_type is the OpenGL type of each component.
      */
     void operator()(char const*     p_attribute_name,
+                    std::uint32_t   p_name_hash,
+                    GLint           p_location,
                     int             p_nb_component,
                     std::size_t     p_offset,
                     std::size_t     p_stride,
                     GLenum          p_component_type) const
     {
-        GLint attribute_id;
-        // ------------------------- DECLARE ------------------------ //
+        bind(find(p_attribute_name, p_name_hash, p_location), p_nb_component, p_component_type, GL_FALSE, p_offset, p_stride);
+    }
 
-        attribute_id = glGetAttribLocation(m_program_id, p_attribute_name);
+    /**
+     * Bind the passed member of an attributes structure, column by column for a matrix.
+     * @param p_attribute is the member, see gl_vertex_layout.
+     * @param p_stride is the stride between two consecutives values.
+     */
+    void operator()(const gl_attribute_desc& p_attribute, std::size_t p_stride) const
+    {
+        GLint attribute_id = find(p_attribute.name, p_attribute.name_hash, p_attribute.location);
+        // ------------------------- DECLARE ------------------------ //
 
         // The attribute id can -1 if the attribute is not used inside the shader
         // or if the attribute start with the reserved prefix "gl_"
-        if(attribute_id != -1)
+        if(attribute_id == -1)
+            return;
+        for(GLuint column = 0; column < p_attribute.columns; ++column)
         {
-            glVertexAttribPointer(attribute_id, p_nb_component, p_component_type, GL_FALSE, p_stride,
-                                  reinterpret_cast<const void*>(p_offset));
-            glEnableVertexAttribArray(attribute_id);
-            glVertexAttribDivisor(attribute_id, m_divisor);
+            bind(attribute_id + column * (p_attribute.slots / p_attribute.columns),
+                 p_attribute.components, p_attribute.gl_type, p_attribute.normalized,
+                 p_attribute.offset + column * (p_attribute.size / p_attribute.columns), p_stride);
         }
     }
 
@@ -62,17 +94,31 @@ struct gl_attribute_binder
      */
     gl_attribute_binder()
         : m_divisor{0}
-        , m_program_id{0}
+        , m_locations{nullptr}
+        , m_vao{0}
+        , m_binding{0}
+        , m_enabled{nullptr}
+        , m_attributes{nullptr}
+        , m_base_offset{0}
     {}
 
     /**
      * \brief Proper constructor.
-     * @param p_program_id is the id of the gl_program.
+     * @param p_locations is the attribute table of the gl_program, or null to bind
+     *                    the attributes to their compile-time locations.
      * @param p_divisor is the divisor for the attribute.
+     * @param p_vao is the vao to edit with direct state access, or 0 to edit the bound vao.
+     * @param p_binding is the binding index the buffer is attached to in p_vao.
      */
-    gl_attribute_binder(gl_types::uid p_program_id, char p_divisor = 0)
+    gl_attribute_binder(const gl_attribute_locations* p_locations, GLuint p_divisor = 0,
+                        gl_types::uid p_vao = 0, GLuint p_binding = 0)
         : m_divisor{p_divisor}
-        , m_program_id{p_program_id}
+        , m_locations{p_locations}
+        , m_vao{p_vao}
+        , m_binding{p_binding}
+        , m_enabled{nullptr}
+        , m_attributes{nullptr}
+        , m_base_offset{0}
     {}
 
     /**
@@ -80,12 +126,96 @@ struct gl_attribute_binder
      */
     gl_attribute_binder(const gl_attribute_binder&) = default;
 
+    // ================================================================ //
+    // ============================ METHODS =========================== //
+    // ================================================================ //
+
+    /**
+     * @brief Set the bit of each attribute enabled in the passed mask.
+     * @param p_enabled is the mask, or null.
+     */
+    gl_attribute_binder& track(std::uint32_t* p_enabled)
+    {
+        m_enabled = p_enabled;
+        return *this;
+    }
+
+    /**
+     * @brief Keep the attributes set without direct state access, with their resolved location.
+     * @param p_attributes receives the attributes, or null.
+     */
+    gl_attribute_binder& record_to(std::vector<priv::vao_attribute>* p_attributes)
+    {
+        m_attributes = p_attributes;
+        return *this;
+    }
+
+    /**
+     * @brief Start the attributes p_bytes after the beginning of the bound buffer.
+     * Only used without direct state access, the offset being a property of the binding otherwise.
+     * @param p_bytes is the offset in bytes.
+     */
+    gl_attribute_binder& offset_by(std::size_t p_bytes)
+    {
+        m_base_offset = p_bytes;
+        return *this;
+    }
+
 
 private:
+    // ================================================================ //
+    // ============================ METHODS =========================== //
+    // ================================================================ //
+
+    // Without program, the locations assigned at compile time are used.
+    GLint find(const char* p_name, std::uint32_t p_name_hash, GLint p_location) const
+    {
+        return m_locations ? m_locations->find(p_name_hash, p_name) : p_location;
+    }
+
+    void bind(GLint p_attribute_id, GLint p_nb_component, GLenum p_component_type, GLboolean p_normalized,
+              std::size_t p_offset, std::size_t p_stride) const
+    {
+        if(p_attribute_id != -1 && p_attribute_id < 32 && m_enabled)
+            *m_enabled |= 1u << p_attribute_id;
+
+        if(p_attribute_id != -1 && m_vao)
+        {
+            // Direct state access: the buffer is attached to m_binding by the caller.
+            gl_object_vertexarrays::gl_enable_attrib(m_vao, p_attribute_id);
+            gl_object_vertexarrays::gl_attrib_format(m_vao, p_attribute_id, p_nb_component, p_component_type, p_normalized, p_offset);
+            gl_object_vertexarrays::gl_attrib_binding(m_vao, p_attribute_id, m_binding);
+        }
+        else if(p_attribute_id != -1)
+        {
+            // Integers and doubles are fetched as is, see gl_object_vertexarrays::gl_attrib_pointer.
+            gl_object_vertexarrays::gl_attrib_pointer(p_attribute_id, p_nb_component, p_component_type, p_normalized, p_stride,
+                                                      reinterpret_cast<const GLvoid*>(m_base_offset + p_offset));
+            gl_object_vertexarrays::gl_enable_attrib(p_attribute_id);
+            gl_object_vertexarrays::gl_attrib_divisor(p_attribute_id, m_divisor);
+            if(m_attributes)
+                m_attributes->push_back(priv::vao_attribute{p_attribute_id, p_nb_component, p_component_type, p_normalized, p_offset});
+        }
+    }
+
+    // ================================================================ //
+    // ============================= FIELDS =========================== //
+    // ================================================================ //
+
     /** The attribute divisor parameter. */
-    char            m_divisor;
-    /** The program id currently bound. */
-    gl_types::uid    m_program_id;
+    GLuint          m_divisor;
+    /** The attribute table of the program currently bound, null to use compile-time locations. */
+    const gl_attribute_locations* m_locations;
+    /** The vao edited with direct state access, 0 for the bound vao. */
+    gl_types::uid   m_vao;
+    /** The binding index of the buffer in m_vao. */
+    GLuint          m_binding;
+    /** Mask of the attributes enabled, can be null. */
+    std::uint32_t*  m_enabled;
+    /** The attributes set without direct state access, can be null. */
+    std::vector<priv::vao_attribute>* m_attributes;
+    /** Offset in bytes added to the attributes, without direct state access. */
+    std::size_t     m_base_offset;
 };
 
 } /* namespacce mgl */
@@ -9,22 +9,49 @@
 #define GLINSTANCED_HPP_
 
 #include <type_traits>
+#include <cstdint>
+#include <cassert>
 #include "../glfwd.hpp"
+#include "../memory/glbuffertrack.hpp"
 
 namespace mgl {
+namespace priv {
+
+/**
+ * @brief How gl_instanced holds its buffer: by reference for a gl_vector, which the vao
+ * follows, and by copy for the light wrappers such as gl_simple_buffer, often temporaries.
+ */
+template<typename T>
+struct instanced_storage
+{
+    typedef const T& type;
+};
+
+template<typename T, typename B>
+struct instanced_storage<gl_simple_buffer<T, B>>
+{
+    typedef gl_simple_buffer<T, B> type;
+};
+
+} /* namespace priv */
 
 /**
  * @ingroup attributes
  * @brief gl_instanced is the class turning on buffer data per instance
+ *
+ * The attributes advance once every divisor instances. The draws may start anywhere in the buffer
+ * through their base instance (see gl_draw_range::with_instances), thus one large buffer can feed
+ * many draws of the same vao.
  */
 template<typename T>
 struct gl_instanced
 {
 
     template<typename U, typename V>
-    friend gl_instanced<gl_vector<U, V>> make_instanced(const gl_vector<U, V>& p_buffer);
+    friend typename std::enable_if<priv::is_gl_attributes<U>::value,
+    gl_instanced<gl_vector<U, V>>>::type make_instanced(const gl_vector<U, V>& p_buffer, GLuint p_divisor);
     template<typename U, typename V>
-    friend gl_instanced<gl_simple_buffer<U, V>> make_instanced(const gl_simple_buffer<U, V>& p_buffer);
+    friend gl_instanced<gl_simple_buffer<U, V>> make_instanced(const gl_simple_buffer<U, V>& p_buffer, GLuint p_divisor);
 
     // ================================================================ //
     // ============================ METHODS =========================== //
@@ -38,6 +65,31 @@ struct gl_instanced
         m_buffer.bind();
     }
 
+    /**
+     * @brief Returns the size of the underlying buffer.
+     */
+    inline std::size_t size() const
+    {
+        return m_buffer.size();
+    }
+
+    /**
+     * @brief Returns the state of the underlying buffer shared with the vaos.
+     * @see gl_vector::track
+     */
+    inline priv::gl_buffer_track_ptr track() const
+    {
+        return m_buffer.track();
+    }
+
+    /**
+     * @brief Returns the id of the underlying buffer.
+     */
+    inline GLuint id() const
+    {
+        return m_buffer.id();
+    }
+
     /**
      * @brief Returns the underlying buffer.
      * @return Returns the underlying buffer.
@@ -48,14 +100,13 @@ struct gl_instanced
     }
 
     /**
-     * @brief Returns the divisor number.
-     * Currently returns just 1. That implies having
-     * the buffer being modified every one instance.
+     * @brief Returns the divisor number: the attributes advance
+     * once every divisor instances.
      * @return Returns the divisor number
      */
-    inline char get_divisor() const
+    inline GLuint get_divisor() const
     {
-        return 1;
+        return m_divisor;
     }
 
 private:
@@ -63,41 +114,50 @@ private:
     // =========================== CTOR/DTOR ========================== //
     // ================================================================ //
 
-    gl_instanced(const T& p_buffer)
+    gl_instanced(const T& p_buffer, GLuint p_divisor)
         : m_buffer(p_buffer)
-    {}
+        , m_divisor(p_divisor)
+    {
+#       ifndef MGL_NDEBUG
+        assert(p_divisor && "The divisor of an instanced buffer can't be 0.");
+#       endif
+    }
 
     // ================================================================ //
     // ============================= FIELDS =========================== //
     // ================================================================ //
 
     /** The buffer that will behave like instanced data. */
-    const T& m_buffer;
+    typename priv::instanced_storage<T>::type m_buffer;
+    /** The attribute divisor. */
+    GLuint m_divisor;
 };
 
 /**
  * @ingroup attributes
  * @brief Transform a buffer into an instanced buffer.
  * @param p_buffer is the buffer to transform.
+ * @param p_divisor is the number of instances drawn with each element.
  * @return Returns the buffer inside the gl_instanced wrapper.
  */
 template<typename T, typename B>
 typename std::enable_if<priv::is_gl_attributes<T>::value,
-gl_instanced<gl_vector<T,B>>>::type make_instanced(const gl_vector<T, B>& p_buffer)
+gl_instanced<gl_vector<T,B>>>::type make_instanced(const gl_vector<T, B>& p_buffer, GLuint p_divisor = 1)
 {
-    return p_buffer;
+    return gl_instanced<gl_vector<T,B>>(p_buffer, p_divisor);
 }
 
 /**
  * @ingroup attributes
  * @brief Transform a simple_buffer into an instanced buffer.
  * @param p_buffer is the buffer to transform.
+ * @param p_divisor is the number of instances drawn with each element.
  * @return Returns the buffer inside the gl_instanced wrapper.
  */
 template<typename T, typename B>
-gl_instanced<gl_simple_buffer<T, B>> make_instanced(const gl_simple_buffer<T, B>& p_buffer)
+gl_instanced<gl_simple_buffer<T, B>> make_instanced(const gl_simple_buffer<T, B>& p_buffer, GLuint p_divisor = 1)
 {
-    return p_buffer;
+    return gl_instanced<gl_simple_buffer<T, B>>(p_buffer, p_divisor);
 }
 
 }  /* namespace mgl */
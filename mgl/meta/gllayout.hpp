@@ -0,0 +1,278 @@
+/*
+ * gllayout.hpp
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: nemikolh
+ */
+
+#ifndef MGL_META_GLLAYOUT_HPP_
+#define MGL_META_GLLAYOUT_HPP_
+
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include "glutil.hpp"
+#include "gltuplesize.hpp"
+#include "glmhelper.hpp"
+#include "../type/gltraits.hpp"
+
+namespace mgl {
+
+/**
+ * @ingroup attributes
+ * @brief Description of one member of an attributes structure, see gl_vertex_layout.
+ *
+ * A matrix is described by one entry, bound as columns attributes of components each,
+ * the column i being at offset + i * size / columns and at location + i * slots / columns.
+ */
+struct gl_attribute_desc
+{
+    /** The name of the member, which is the name of the attribute in the shaders. */
+    const char*     name;
+    /** The hash of the name, see priv::hash_str. */
+    std::uint32_t   name_hash;
+    /** The offset of the member in the structure. */
+    std::size_t     offset;
+    /** The size in bytes of the member. */
+    std::size_t     size;
+    /** The location assigned at compile time, see attribute_location. */
+    GLuint          location;
+    /** The number of locations taken, see attribute_slots. */
+    GLuint          slots;
+    /** The number of columns, 1 unless the member is a matrix. */
+    GLuint          columns;
+    /** The number of components of each column. */
+    GLint           components;
+    /** The type of the components (GL_FLOAT, ...). */
+    GLenum          gl_type;
+    /** True when integers are converted to floats in [0, 1] or [-1, 1], see attribute_normalized. */
+    bool            normalized;
+    /** True when the shaders read the member as integers. */
+    bool            integer;
+};
+
+namespace priv {
+
+/*
+ * The indices of the members, 0 to N - 1. Before C++14, the sequence is built by halves,
+ * which keeps the instantiation depth logarithmic in the number of members.
+ */
+#if __cplusplus >= 201402L
+
+template<std::size_t... I>
+using indices = std::index_sequence<I...>;
+
+template<std::size_t N>
+using make_indices = std::make_index_sequence<N>;
+
+#else
+
+template<std::size_t... I>
+struct indices
+{
+    typedef indices type;
+};
+
+template<typename L, typename R>
+struct concat_indices;
+
+template<std::size_t... L, std::size_t... R>
+struct concat_indices<indices<L...>, indices<R...>> : indices<L..., (sizeof...(L) + R)...>
+{};
+
+template<std::size_t N>
+struct make_indices_impl : concat_indices<typename make_indices_impl<N / 2>::type,
+                                          typename make_indices_impl<N - N / 2>::type>
+{};
+
+template<>
+struct make_indices_impl<0> : indices<>
+{};
+
+template<>
+struct make_indices_impl<1> : indices<0>
+{};
+
+template<std::size_t N>
+using make_indices = typename make_indices_impl<N>::type;
+
+#endif
+
+/**
+ * @brief Returns the description of the N-th member of T.
+ */
+template<typename T, unsigned int N>
+constexpr gl_attribute_desc make_attribute_desc()
+{
+    typedef typename value_at<T, N>::type               member_t;
+    typedef typename attribute_column<member_t>::type   column_t;
+    static_assert(tuple_size<column_t>::value < 5, "The tuple size must be either 1, 2, 3 or 4. GL_BGRA is not currently supported.");
+
+    return gl_attribute_desc{
+        struct_member_name<T, N>::call(),
+        struct_member_name<T, N>::hash,
+        offset_at<T, N>::value,
+        sizeof(member_t),
+        attribute_location<T, N>::value,
+        attribute_slots<member_t>::value,
+        attribute_columns<member_t>::value,
+        static_cast<GLint>(tuple_size<column_t>::value),
+        tuple_component_type<column_t>::value,
+        attribute_normalized<T, N>::value,
+        is_integer_component(tuple_component_type<column_t>::value) && !attribute_normalized<T, N>::value
+    };
+}
+
+/**
+ * @brief Returns the attribute as it is bound.
+ *
+ * Without OpenGL 4.1 or ARB_vertex_attrib_64bit, the doubles are converted to float: a dvec3
+ * or dvec4 column then takes one location instead of two, and the following members move down.
+ * @param p_attribute is the member, as described at compile time.
+ * @param p_shift is the number of locations freed by the previous members, updated by the call.
+ */
+inline gl_attribute_desc bound_attribute(const gl_attribute_desc& p_attribute, GLuint& p_shift)
+{
+    gl_attribute_desc bound = p_attribute;
+    // ------------------------- DECLARE ------------------------ //
+
+    bound.location -= p_shift;
+    if(bound.slots != bound.columns && !has_vertex_attrib_64bit())
+    {
+        p_shift += bound.slots - bound.columns;
+        bound.slots = bound.columns;
+    }
+    return bound;
+}
+
+/*
+ * FNV-1a, 64 bits. The integers are hashed as 4 bytes, least significant first.
+ */
+constexpr std::uint64_t fnv_basis = 0xcbf29ce484222325ULL;
+
+constexpr std::uint64_t fnv_byte(std::uint64_t p_hash, unsigned char p_byte)
+{
+    return (p_hash ^ p_byte) * 0x100000001b3ULL;
+}
+
+constexpr std::uint64_t fnv_u32(std::uint64_t p_hash, std::uint32_t p_value)
+{
+    return fnv_byte(fnv_byte(fnv_byte(fnv_byte(p_hash, p_value & 0xff), (p_value >> 8) & 0xff),
+                             (p_value >> 16) & 0xff), (p_value >> 24) & 0xff);
+}
+
+constexpr std::uint64_t fnv_str(std::uint64_t p_hash, const char* p_str)
+{
+    return *p_str ? fnv_str(fnv_byte(p_hash, static_cast<unsigned char>(*p_str)), p_str + 1) : p_hash;
+}
+
+constexpr std::uint64_t fnv_flag(std::uint64_t p_hash, bool p_flag)
+{
+    return fnv_byte(p_hash, p_flag ? 1 : 0);
+}
+
+/*
+ * Hash of what is stored in a file or a buffer: names, offsets, components, types and normalization.
+ */
+constexpr std::uint64_t hash_attribute_data(std::uint64_t p_hash, const gl_attribute_desc& p_a)
+{
+    return fnv_flag(fnv_u32(fnv_u32(fnv_u32(fnv_str(p_hash, p_a.name), p_a.offset), p_a.components * p_a.columns),
+                            p_a.gl_type), p_a.normalized);
+}
+
+/*
+ * Hash of what is stored in a vao: locations, offsets and formats, but neither the names nor the stride.
+ */
+constexpr std::uint64_t hash_attribute_format(std::uint64_t p_hash, const gl_attribute_desc& p_a)
+{
+    return fnv_flag(fnv_u32(fnv_u32(fnv_u32(fnv_u32(fnv_u32(p_hash, p_a.location), p_a.columns), p_a.components),
+                                    p_a.gl_type), p_a.offset), p_a.normalized);
+}
+
+constexpr std::uint64_t hash_data(std::uint64_t p_hash)
+{
+    return p_hash;
+}
+
+template<typename... A>
+constexpr std::uint64_t hash_data(std::uint64_t p_hash, const gl_attribute_desc& p_first, const A&... p_rest)
+{
+    return hash_data(hash_attribute_data(p_hash, p_first), p_rest...);
+}
+
+constexpr std::uint64_t hash_format(std::uint64_t p_hash)
+{
+    return p_hash;
+}
+
+template<typename... A>
+constexpr std::uint64_t hash_format(std::uint64_t p_hash, const gl_attribute_desc& p_first, const A&... p_rest)
+{
+    return hash_format(hash_attribute_format(p_hash, p_first), p_rest...);
+}
+
+template<typename T, typename Indices>
+struct vertex_layout_impl;
+
+template<typename T, std::size_t... I>
+struct vertex_layout_impl<T, indices<I...>>
+{
+    static constexpr std::size_t        size = sizeof...(I);
+    static constexpr gl_attribute_desc  attributes[sizeof...(I)] = { make_attribute_desc<T, I>()... };
+    static constexpr std::uint64_t      hash = fnv_u32(hash_data(fnv_basis, make_attribute_desc<T, I>()...), sizeof(T));
+    static constexpr std::uint64_t      format_hash = hash_format(fnv_basis, make_attribute_desc<T, I>()...);
+};
+
+template<typename T, std::size_t... I>
+constexpr gl_attribute_desc vertex_layout_impl<T, indices<I...>>::attributes[sizeof...(I)];
+
+}  /* namespace priv */
+
+/**
+ * @ingroup attributes
+ * @brief gl_vertex_layout is the description of an attributes structure, computed at compile time.
+ *
+ *  @code
+ *      MGL_DEFINE_GL_ATTRIBUTES(, vertex, (glm::vec3, position)(glm::vec2, uv))
+ *      typedef mgl::gl_vertex_layout<vertex> layout;
+ *      static_assert(layout::size == 2 && layout::attributes[1].offset == sizeof(glm::vec3), "");
+ *      for(const mgl::gl_attribute_desc& a : layout::attributes)
+ *          ...
+ *  @endcode
+ *
+ * Two hashes are provided:
+ *  - hash identifies the data: two structures with the same hash have the same names, offsets,
+ *    components, types and stride, their content can be copied with a memcpy (see mesh_file),
+ *  - format_hash identifies what a vao stores: two structures with the same format_hash
+ *    can be drawn with the same vao, given their buffers (see gl_vertex_format).
+ */
+template<typename T>
+struct gl_vertex_layout : priv::vertex_layout_impl<T, priv::make_indices<priv::seq_size<T>::value>>
+{
+    static_assert(priv::is_gl_attributes<T>::value, "T must be declared with MGL_DEFINE_GL_ATTRIBUTES.");
+
+    /** The distance between two consecutive elements. */
+    static constexpr std::size_t stride = sizeof(T);
+
+    /**
+     * @brief Returns the location the p_n-th member is bound to.
+     *
+     * It is attributes[p_n].location, unless the doubles are converted to float
+     * (see priv::has_vertex_attrib_64bit): the dvec3 and dvec4 members before p_n
+     * then take one location per column instead of two.
+     * @param p_n is the index of the member.
+     */
+    static GLuint location(std::size_t p_n)
+    {
+        GLuint shift = 0;
+        // ------------------------- DECLARE ------------------------ //
+
+        for(std::size_t i = 0; i < p_n; ++i)
+            priv::bound_attribute(gl_vertex_layout::attributes[i], shift);
+        return gl_vertex_layout::attributes[p_n].location - shift;
+    }
+};
+
+}  /* namespace mgl */
+
+#endif /* MGL_META_GLLAYOUT_HPP_ */
@@ -0,0 +1,178 @@
+/*
+ * glpacking.hpp
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: nemikolh
+ */
+
+#ifndef MGL_META_GLPACKING_HPP_
+#define MGL_META_GLPACKING_HPP_
+
+#include <cstddef>
+#include "glutil.hpp"
+#include "gllayout.hpp"
+
+namespace mgl {
+namespace priv {
+
+/** GL fetches the attributes faster when they start on a 4 bytes boundary. */
+constexpr std::size_t gl_attribute_alignment = 4;
+
+constexpr std::size_t align_up(std::size_t p_value, std::size_t p_alignment)
+{
+    return (p_value + p_alignment - 1) / p_alignment * p_alignment;
+}
+
+constexpr std::size_t max_of(std::size_t p_a, std::size_t p_b)
+{
+    return p_a < p_b ? p_b : p_a;
+}
+
+template<typename T, typename Indices>
+struct packing_data;
+
+/*
+ * The alignment, the size and the current offset of each member.
+ */
+template<typename T, std::size_t... I>
+struct packing_data<T, indices<I...>>
+{
+    static constexpr std::size_t count = sizeof...(I);
+    static constexpr std::size_t alignment[sizeof...(I)] = { alignof(typename value_at<T, I>::type)... };
+    static constexpr std::size_t size[sizeof...(I)] = { sizeof(typename value_at<T, I>::type)... };
+    static constexpr std::size_t offset[sizeof...(I)] = { offset_at<T, I>::value... };
+};
+
+template<typename T, std::size_t... I>
+constexpr std::size_t packing_data<T, indices<I...>>::alignment[sizeof...(I)];
+template<typename T, std::size_t... I>
+constexpr std::size_t packing_data<T, indices<I...>>::size[sizeof...(I)];
+template<typename T, std::size_t... I>
+constexpr std::size_t packing_data<T, indices<I...>>::offset[sizeof...(I)];
+
+/*
+ * The members are sorted by decreasing alignment, the declaration order being kept for equal
+ * alignments. As the sizes are multiples of the alignments, each member then starts right after
+ * the previous one, and the only padding left is at the end of the structure: no order has a
+ * smaller stride. The members smaller than gl_attribute_alignment are packed together at the end,
+ * thus only the ones which can't start on a 4 bytes boundary without growing the stride don't.
+ */
+template<typename D>
+constexpr bool placed_before(std::size_t p_j, std::size_t p_i)
+{
+    return D::alignment[p_j] > D::alignment[p_i]
+       || (D::alignment[p_j] == D::alignment[p_i] && p_j < p_i);
+}
+
+template<typename D>
+constexpr std::size_t planned_rank(std::size_t p_i, std::size_t p_j = 0)
+{
+    return p_j == D::count ? 0 : (placed_before<D>(p_j, p_i) ? 1 : 0) + planned_rank<D>(p_i, p_j + 1);
+}
+
+template<typename D>
+constexpr std::size_t planned_offset(std::size_t p_i, std::size_t p_j = 0)
+{
+    return p_j == D::count ? 0 : (placed_before<D>(p_j, p_i) ? D::size[p_j] : 0) + planned_offset<D>(p_i, p_j + 1);
+}
+
+template<typename D>
+constexpr unsigned int planned_member(std::size_t p_rank, std::size_t p_i = 0)
+{
+    return planned_rank<D>(p_i) == p_rank ? p_i : planned_member<D>(p_rank, p_i + 1);
+}
+
+template<typename D>
+constexpr std::size_t sum_of(const std::size_t* p_values, std::size_t p_i = 0)
+{
+    return p_i == D::count ? 0 : p_values[p_i] + sum_of<D>(p_values, p_i + 1);
+}
+
+template<typename D>
+constexpr std::size_t max_alignment(std::size_t p_i = 0)
+{
+    return p_i == D::count ? 1 : max_of(D::alignment[p_i], max_alignment<D>(p_i + 1));
+}
+
+template<typename D>
+constexpr std::size_t count_misaligned(std::size_t p_i = 0)
+{
+    return p_i == D::count ? 0 : (D::offset[p_i] % gl_attribute_alignment ? 1 : 0) + count_misaligned<D>(p_i + 1);
+}
+
+template<typename D>
+constexpr std::size_t count_planned_misaligned(std::size_t p_i = 0)
+{
+    return p_i == D::count ? 0 : (planned_offset<D>(p_i) % gl_attribute_alignment ? 1 : 0) + count_planned_misaligned<D>(p_i + 1);
+}
+
+template<typename T, typename Indices>
+struct layout_plan_impl;
+
+template<typename T, std::size_t... I>
+struct layout_plan_impl<T, indices<I...>>
+{
+    typedef packing_data<T, indices<I...>> data;
+
+    static constexpr std::size_t    stride = sizeof(T);
+    static constexpr std::size_t    data_size = sum_of<data>(data::size);
+    static constexpr std::size_t    wasted_bytes = stride - data_size;
+    static constexpr std::size_t    misaligned = count_misaligned<data>();
+    static constexpr std::size_t    planned_misaligned = count_planned_misaligned<data>();
+    static constexpr std::size_t    packed_stride = align_up(data_size, max_alignment<data>());
+    static constexpr unsigned int   order[sizeof...(I)] = { planned_member<data>(I)... };
+    static constexpr std::size_t    offsets[sizeof...(I)] = { planned_offset<data>(I)... };
+};
+
+template<typename T, std::size_t... I>
+constexpr unsigned int layout_plan_impl<T, indices<I...>>::order[sizeof...(I)];
+template<typename T, std::size_t... I>
+constexpr std::size_t layout_plan_impl<T, indices<I...>>::offsets[sizeof...(I)];
+
+}  /* namespace priv */
+
+/**
+ * @ingroup attributes
+ * @brief gl_layout_plan tells, at compile time, how well an attributes structure is packed.
+ *
+ * The members of a structure declared with #MGL_DEFINE_GL_ATTRIBUTES are laid out in the
+ * declaration order, thus a small member followed by a large one is padded. The plan sorts the
+ * members by decreasing alignment, which gives the smallest stride any order can have, and
+ * starts on a 4 bytes boundary, as GL expects, every member that can without growing the stride:
+ *  - stride is the current stride, data_size the sum of the sizes of the members,
+ *  - wasted_bytes is the padding of each vertex, stride - data_size, part of which may be
+ *    the padding at the end that no order removes,
+ *  - misaligned is the number of members not starting on a 4 bytes boundary,
+ *    planned_misaligned the same in the planned order,
+ *  - packed_stride is the stride of the planned order, saved_bytes what it saves per vertex,
+ *  - order lists the members in the planned order, offsets gives their planned offset.
+ *
+ * The structure can't be reordered by the library, as the members are accessed by name.
+ * Declaring them in the planned order changes their locations (see attribute_location), the
+ * shaders using explicit locations must be updated too.
+ *  @code
+ *      MGL_DEFINE_GL_ATTRIBUTES(, vertex, (float, weight)(double, time)(glm::vec3, position))
+ *      typedef mgl::gl_layout_plan<vertex> plan;
+ *      // 32 bytes for 24 bytes of data, 24 bytes declared as (time)(weight)(position).
+ *      static_assert(plan::stride == 32 && plan::packed_stride == 24 && plan::order[0] == 1, "");
+ *      // Fails the compilation as soon as a declaration can be packed better.
+ *      static_assert(plan::is_packed, "Reorder the members, see gl_layout_plan<vertex>::order.");
+ *  @endcode
+ */
+template<typename T>
+struct gl_layout_plan : priv::layout_plan_impl<T, priv::make_indices<priv::seq_size<T>::value>>
+{
+    static_assert(priv::is_gl_attributes<T>::value, "T must be declared with MGL_DEFINE_GL_ATTRIBUTES.");
+
+    typedef priv::layout_plan_impl<T, priv::make_indices<priv::seq_size<T>::value>> base;
+
+    /** The bytes saved per vertex by the planned order. */
+    static constexpr std::size_t saved_bytes = base::stride > base::packed_stride ? base::stride - base::packed_stride : 0;
+
+    /** True when the current order is as good as the planned one: same stride, and no more misaligned members. */
+    static constexpr bool is_packed = saved_bytes == 0 && base::misaligned <= base::planned_misaligned;
+};
+
+}  /* namespace mgl */
+
+#endif /* MGL_META_GLPACKING_HPP_ */
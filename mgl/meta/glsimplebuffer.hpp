@@ -9,7 +9,9 @@
 #define GLSINGLEBUFFER_HPP_
 
 #include <type_traits>
+#include <cstdint>
 #include "../glfwd.hpp"
+#include "../memory/glbuffertrack.hpp"
 
 namespace mgl {
 
@@ -41,7 +43,7 @@ template<typename T, typename B>
 struct gl_simple_buffer
 {
     template<typename U, typename V>
-    friend gl_simple_buffer<U, V> make_buffer(const gl_vector<U, V>&, const char*);
+    friend gl_simple_buffer<U, V> make_buffer(const gl_vector<U, V>&, const char*, GLint);
 
     // ================================================================ //
     // ============================ METHODS =========================== //
@@ -65,6 +67,39 @@ struct gl_simple_buffer
         return m_name;
     }
 
+    /**
+     * @brief Returns the location of the attribute for the vaos made without program, or -1.
+     */
+    inline GLint location() const
+    {
+        return m_location;
+    }
+
+    /**
+     * @brief Returns the size of the underlying buffer.
+     */
+    inline std::size_t size() const
+    {
+        return m_buffer.size();
+    }
+
+    /**
+     * @brief Returns the state of the underlying buffer shared with the vaos.
+     * @see gl_vector::track
+     */
+    inline priv::gl_buffer_track_ptr track() const
+    {
+        return m_buffer.track();
+    }
+
+    /**
+     * @brief Returns the id of the underlying buffer.
+     */
+    inline GLuint id() const
+    {
+        return m_buffer.id();
+    }
+
     /**
      * @brief Returns the underlying buffer.
      * @return Returns the underlying buffer.
@@ -80,9 +115,10 @@ private:
     // =========================== CTOR/DTOR ========================== //
     // ================================================================ //
 
-    gl_simple_buffer(const gl_vector<T,B> & p_buffer, const char* p_name)
+    gl_simple_buffer(const gl_vector<T,B> & p_buffer, const char* p_name, GLint p_location)
         : m_buffer(p_buffer)
         , m_name(p_name)
+        , m_location(p_location)
     {}
 
     // ================================================================ //
@@ -91,6 +127,7 @@ private:
 
     const gl_vector<T, B> & m_buffer;
     const char* m_name;
+    GLint       m_location;
 };
 
 
@@ -100,15 +137,18 @@ private:
  * @brief Enables to bind automatically a buffer which does not have a name.
  * This function give a name to the passed buffer.
  * Note that you can't call the function on a buffer defined by #MGL_DEFINE_GL_ATTRIBUTES.
+ * The name is looked up in the attribute table of the program making the vao. A vao made
+ * without program (see mgl::make_vao) has no table, the location must then be passed.
  * @param p_buffer is the name of the buffer.
  * @param p_name is the name for the attribute.
+ * @param p_location is the location of the attribute, for the vaos made without program.
  * @return Returns a clue for the automatic binding buffers facility.
  */
 template<typename T, typename B>
-gl_simple_buffer<T, B> make_buffer(const gl_vector<T, B>& p_buffer, const char* p_name)
+gl_simple_buffer<T, B> make_buffer(const gl_vector<T, B>& p_buffer, const char* p_name, GLint p_location = -1)
 {
     static_assert(!priv::is_gl_attributes<T>::value, "T must be a single attribute data type (glm::vec3, float, ...)");
-    return gl_simple_buffer<T, B>(p_buffer, p_name);
+    return gl_simple_buffer<T, B>(p_buffer, p_name, p_location);
 }
 
 
@@ -70,6 +70,18 @@ public:
 
 };
 
+template<typename T>
+struct column_type_glm
+{
+    typedef typename T::col_type type;
+};
+
+template<typename T>
+struct identity
+{
+    typedef T type;
+};
+
 }  /* namespace priv */
 
 
@@ -101,7 +113,45 @@ struct matrix_size
 	static constexpr typename type::value_type value = type::value;
 };
 
+/**
+ * Meta function returning the number of attributes T is bound as:
+ * one per column for a matrix, one otherwise.
+ */
+template<typename T>
+struct attribute_columns
+{
+    typedef
+        typename priv::eval_if< is_matrix<T>
+            , priv::matrix_size_glm<T>
+            , priv::int_<1>
+        >::type         type;
+    static constexpr typename type::value_type value = type::value;
+};
+
+/**
+ * Meta function returning the type of each attribute T is bound as:
+ * the column type for a matrix, T otherwise.
+ */
+template<typename T>
+struct attribute_column
+{
+    typedef
+        typename priv::eval_if< is_matrix<T>
+            , priv::column_type_glm<T>
+            , priv::identity<T>
+        >::type         type;
+};
 
+/**
+ * Meta function returning the number of attribute locations taken by T:
+ * one per column, two for the columns wider than 16 bytes (dvec3, dvec4).
+ */
+template<typename T>
+struct attribute_slots
+{
+    static constexpr unsigned int per_column = sizeof(typename attribute_column<T>::type) > 16 ? 2 : 1;
+    static constexpr unsigned int value = attribute_columns<T>::value * per_column;
+};
 
 }  /* namespace mgl */
 
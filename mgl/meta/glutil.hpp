@@ -8,6 +8,8 @@
 #ifndef MGL_UTIL_HPP_
 #define MGL_UTIL_HPP_
 
+#include <cstdint>
+
 namespace mgl {
 
 template<typename T, unsigned int N>
@@ -22,6 +24,72 @@ template<typename T, unsigned int N>
 struct struct_member_name
 {};
 
+/**
+ * @brief First attribute location used by the attributes structure T.
+ *
+ * Specialize it when a program consumes several attributes structures,
+ * for instance per vertex and per instance data, so that their locations don't overlap:
+ *  @code
+ *      namespace mgl {
+ *      template<>
+ *      struct attribute_location_base<my_instance_data>
+ *      {
+ *          static constexpr unsigned int value = 8;
+ *      };
+ *      }
+ *  @endcode
+ */
+template<typename T>
+struct attribute_location_base
+{
+    static constexpr unsigned int value = 0;
+};
+
+/**
+ * @brief Tells whether the N-th member of T, made of integers, is normalized when read by the shaders:
+ * converted to a float in [0, 1] for the unsigned types and in [-1, 1] for the signed ones.
+ *
+ * By default integers are read as integers. Specialize it for colors stored as bytes, for instance:
+ *  @code
+ *      namespace mgl {
+ *      template<>
+ *      struct attribute_normalized<my_vertex, 2>
+ *      {
+ *          static constexpr bool value = true;
+ *      };
+ *      }
+ *  @endcode
+ */
+template<typename T, unsigned int N>
+struct attribute_normalized
+{
+    static constexpr bool value = false;
+};
+
+/* Forward declaration, see gltuplesize.hpp */
+template<typename T>
+struct attribute_slots;
+
+/**
+ * @brief Attribute location of the N-th member of T, assigned at compile time.
+ *
+ * The location only depends on the members of T, hence every program
+ * consuming T agrees on it and a vao can be shared between them.
+ * A matrix member takes one location per column.
+ */
+template<typename T, unsigned int N>
+struct attribute_location
+{
+    static constexpr unsigned int value = attribute_location<T, N - 1>::value
+                                        + attribute_slots<typename value_at<T, N - 1>::type>::value;
+};
+
+template<typename T>
+struct attribute_location<T, 0>
+{
+    static constexpr unsigned int value = attribute_location_base<T>::value;
+};
+
 namespace priv {
 
 template<typename T>
@@ -56,6 +124,15 @@ struct eval_if
     typedef typename _f::type type;
 };
 
+/**
+ * @brief FNV-1a hash of a string, usable at compile time.
+ * Used to look up attributes by name without string comparisons.
+ */
+constexpr std::uint32_t hash_str(const char* p_str, std::uint32_t p_hash = 2166136261u)
+{
+    return *p_str ? hash_str(p_str + 1, (p_hash ^ static_cast<unsigned char>(*p_str)) * 16777619u) : p_hash;
+}
+
 template<typename N, typename D>
 struct divides
 {
@@ -0,0 +1,137 @@
+/*
+ * glattributelocations.hpp
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: nemikolh
+ */
+
+#ifndef MGL_TYPE_GLATTRIBUTELOCATIONS_HPP_
+#define MGL_TYPE_GLATTRIBUTELOCATIONS_HPP_
+
+#include <vector>
+#include <string>
+#include <algorithm>
+#include "gltraits.hpp"
+#include "globjsh.hpp"
+#include "../meta/glutil.hpp"
+
+namespace mgl {
+
+/**
+ * @ingroup attributes
+ * @brief gl_attribute_locations is the table of the active attributes of a linked program.
+ *
+ * The table is filled once, when the program is linked, and then resolves
+ * attribute locations from the hash of their name without any OpenGL query.
+ * Names of attributes declared with #MGL_DEFINE_GL_ATTRIBUTES are hashed at compile time,
+ * the name is only compared on a hit, so that two names with the same hash never collide.
+ */
+struct gl_attribute_locations
+{
+    // ================================================================ //
+    // =========================== CTOR/DTOR ========================== //
+    // ================================================================ //
+
+    gl_attribute_locations()
+        : m_entries()
+        , m_reflected(false)
+    {}
+
+    // ================================================================ //
+    // ============================ METHODS =========================== //
+    // ================================================================ //
+
+    /**
+     * @brief Query the active attributes of the passed program and store their locations.
+     * @param p_program_id is the id of a linked program.
+     */
+    void reflect(gl_types::uid p_program_id)
+    {
+        GLint count  = gl_object_program::gl_active_attributes(p_program_id);
+        GLint length = gl_object_program::gl_active_attribute_max_length(p_program_id);
+        std::vector<GLchar> name(std::max(length, 1));
+        // ------------------------- DECLARE ------------------------ //
+
+        m_entries.clear();
+        for(GLint i = 0; i < count; ++i)
+        {
+            GLsizei len = gl_object_program::gl_active_attribute(p_program_id, i, name.size(), name.data());
+            // Arrays are reported as "name[0]" but looked up as "name".
+            if(len > 3 && std::equal(name.begin() + len - 3, name.begin() + len, "[0]"))
+                name[len - 3] = '\0';
+            GLint location = gl_object_program::gl_attrib_location(p_program_id, name.data());
+            // Built-in attributes (gl_VertexID, ...) don't have a location.
+            if(location != -1)
+                m_entries.push_back(entry{priv::hash_str(name.data()), location, name.data()});
+        }
+        std::sort(m_entries.begin(), m_entries.end(),
+                  [](const entry& a, const entry& b) { return a.hash < b.hash; });
+        m_reflected = true;
+    }
+
+    /**
+     * @brief Returns true once reflect() has been called.
+     */
+    bool is_reflected() const
+    {
+        return m_reflected;
+    }
+
+    /**
+     * @brief Returns the location of the passed attribute, whose hash is already known.
+     * @param p_name_hash is the hash of the name, computed with priv::hash_str.
+     * @param p_name is the name of the attribute.
+     * @return Returns the location or -1 if the attribute isn't active.
+     */
+    gl_types::id find(std::uint32_t p_name_hash, const char* p_name) const
+    {
+        auto it = std::lower_bound(m_entries.begin(), m_entries.end(), p_name_hash,
+                                   [](const entry& e, std::uint32_t h) { return e.hash < h; });
+        for(; it != m_entries.end() && it->hash == p_name_hash; ++it)
+        {
+            if(it->name == p_name)
+                return it->location;
+        }
+        return -1;
+    }
+
+    /**
+     * @brief Returns the location of the passed attribute.
+     * @param p_name is the name of the attribute.
+     * @return Returns the location or -1 if the attribute isn't active.
+     */
+    gl_types::id find(const char* p_name) const
+    {
+        return find(priv::hash_str(p_name), p_name);
+    }
+
+    /**
+     * @brief Returns the number of active attributes.
+     */
+    std::size_t size() const
+    {
+        return m_entries.size();
+    }
+
+private:
+
+    struct entry
+    {
+        std::uint32_t hash;
+        gl_types::id  location;
+        std::string   name;
+    };
+
+    // ================================================================ //
+    // ============================= FIELDS =========================== //
+    // ================================================================ //
+
+    /** Active attributes sorted by hash. */
+    std::vector<entry> m_entries;
+    /** True when the table has been filled. */
+    bool               m_reflected;
+};
+
+}  /* namespace mgl */
+
+#endif /* MGL_TYPE_GLATTRIBUTELOCATIONS_HPP_ */
@@ -0,0 +1,127 @@
+/*
+ * gldrawcommand.hpp
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: nemikolh
+ */
+
+#ifndef MGL_TYPE_GLDRAWCOMMAND_HPP_
+#define MGL_TYPE_GLDRAWCOMMAND_HPP_
+
+#include <cstddef>
+#include <limits>
+#include "gltraits.hpp"
+
+namespace mgl {
+
+/**
+ * @brief The command read by glMultiDrawElementsIndirect, one per mesh.
+ *
+ * The layout is fixed by OpenGL, see gl_draw_indirect.
+ */
+struct draw_elements_indirect_command
+{
+    /** Number of indices. */
+    GLuint count;
+    /** Number of instances. */
+    GLuint instance_count;
+    /** First index in the element buffer. */
+    GLuint first_index;
+    /** Value added to each index. */
+    GLint  base_vertex;
+    /** First instance, offset of the instanced attributes. */
+    GLuint base_instance;
+};
+
+/**
+ * @brief gl_draw_range describes what part of a vao to draw, and how.
+ *
+ * The range is in indices when the vao has an element buffer, in vertices otherwise.
+ *  @code
+ *      // Draw the second mesh packed in the buffers of the vao.
+ *      mgl::gl_draw(vao, mgl::gl_draw_range(GL_TRIANGLES, mesh.first_index, mesh.count).with_base_vertex(mesh.first_vertex));
+ *  @endcode
+ */
+struct gl_draw_range
+{
+    /** The count meaning "up to the end of the buffer". */
+    static constexpr std::size_t all = std::numeric_limits<std::size_t>::max();
+
+    // ================================================================ //
+    // =========================== CTOR/DTOR ========================== //
+    // ================================================================ //
+
+    /**
+     * @brief Constructor.
+     * @param p_mode is the primitive mode.
+     * @param p_first is the first index, or vertex without element buffer.
+     * @param p_count is the number of indices, or vertices, to draw.
+     */
+    gl_draw_range(GLenum p_mode = GL_TRIANGLES, std::size_t p_first = 0, std::size_t p_count = all)
+        : mode(p_mode)
+        , first(p_first)
+        , count(p_count)
+        , base_vertex(0)
+        , instance_count(1)
+        , base_instance(0)
+    {}
+
+    // ================================================================ //
+    // ============================ METHODS =========================== //
+    // ================================================================ //
+
+    /**
+     * @brief Set the value added to each index. Only used with an element buffer.
+     */
+    gl_draw_range& with_base_vertex(GLint p_base_vertex)
+    {
+        base_vertex = p_base_vertex;
+        return *this;
+    }
+
+    /**
+     * @brief Set the instances to draw.
+     * @param p_instance_count is the number of instances.
+     * @param p_base_instance is the first instance, requires OpenGL 4.2 or ARB_base_instance if not 0.
+     */
+    gl_draw_range& with_instances(std::size_t p_instance_count, GLuint p_base_instance = 0)
+    {
+        instance_count = p_instance_count;
+        base_instance  = p_base_instance;
+        return *this;
+    }
+
+    // ================================================================ //
+    // ============================= FIELDS =========================== //
+    // ================================================================ //
+
+    /** The primitive mode. */
+    GLenum      mode;
+    /** The first index, or vertex. */
+    std::size_t first;
+    /** The number of indices, or vertices. */
+    std::size_t count;
+    /** Value added to each index. */
+    GLint       base_vertex;
+    /** Number of instances. */
+    std::size_t instance_count;
+    /** First instance. */
+    GLuint      base_instance;
+};
+
+static_assert(sizeof(draw_elements_indirect_command) == 5 * sizeof(GLuint),
+              "draw_elements_indirect_command must be tightly packed.");
+
+/**
+ * @brief The commands are stored in the draw indirect buffer (OpenGL 4.0).
+ */
+template<>
+struct gl_buffer_type<draw_elements_indirect_command>
+{
+    static constexpr GLenum target = GL_DRAW_INDIRECT_BUFFER;
+    static constexpr GLenum usage  = GL_DYNAMIC_DRAW;
+};
+
+}  /* namespace mgl */
+
+#endif /* MGL_TYPE_GLDRAWCOMMAND_HPP_ */
@@ -8,6 +8,9 @@
 #ifndef GLENUM_HPP_
 #define GLENUM_HPP_
 
+#include <cstdint>
+#include <type_traits>
+
 namespace mgl {
 
 /**
@@ -19,13 +22,20 @@ struct gl_enum_from_type;
 /**
  * \class tuple_component_type is a MetaFunction to specify the gl value type of your tuple.
  *
+ * Arithmetic types are their own component type.
  */
-template<typename T>
+template<typename T, bool = std::is_arithmetic<T>::value>
 struct tuple_component_type
 {
     static constexpr GLenum value = gl_enum_from_type<typename T::value_type>::value;
 };
 
+template<typename T>
+struct tuple_component_type<T, true>
+{
+    static constexpr GLenum value = gl_enum_from_type<T>::value;
+};
+
 /**
  * Partial specialization for C++ primitives types.
  */
@@ -85,6 +95,30 @@ struct gl_enum_from_type<double>
     static constexpr GLenum value = GL_DOUBLE;
 };
 
+namespace priv {
+
+/**
+ * @brief Returns true if the attributes of the passed component type are integers
+ * for the shaders (int, uint, ivec*, uvec*), fetched without conversion to float.
+ */
+constexpr bool is_integer_component(GLenum p_type)
+{
+    return p_type == GL_BYTE || p_type == GL_UNSIGNED_BYTE
+        || p_type == GL_SHORT || p_type == GL_UNSIGNED_SHORT
+        || p_type == GL_INT || p_type == GL_UNSIGNED_INT;
+}
+
+/**
+ * @brief Returns true if the attributes of the passed component type are doubles
+ * for the shaders (double, dvec*), fetched without conversion to float.
+ */
+constexpr bool is_double_component(GLenum p_type)
+{
+    return p_type == GL_DOUBLE;
+}
+
+}  /* namespace priv */
+
 
 }  /* namespace mgl */
 
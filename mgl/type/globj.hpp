@@ -8,6 +8,8 @@
 #ifndef GLOBJ_HPP_
 #define GLOBJ_HPP_
 
+#include "glstatecache.hpp"
+
 namespace mgl {
 
 // -----------------------------------------------------------------------------------------------------------------------------------//
@@ -15,6 +17,12 @@ namespace mgl {
 
 /*
  * Opengl object definitions.
+ *
+ * When the direct state access functions are available (see priv::has_direct_state_access),
+ * the objects are created with glCreate* and edited by name: no bind call is issued.
+ * Otherwise the object is bound to its target before being edited.
+ *
+ * Binds are filtered by the gl_state_cache made current, if any.
  */
 template<typename Buff>
 struct gl_object_buffer
@@ -28,37 +36,135 @@ struct gl_object_buffer
 #ifdef NKH_TEST
         counter += p_n;
 #endif
-        glCheck(glGenBuffers(p_n, p_buffers));
+        if(priv::has_direct_state_access())
+            glCheck(glCreateBuffers(p_n, p_buffers));
+        else
+            glCheck(glGenBuffers(p_n, p_buffers));
     }
 
     static inline void gl_bind(GLuint p_id)
     {
-        glCheck(glBindBuffer(Buff::target, p_id));
+        if(gl_state_cache::current().change_buffer(Buff::target, p_id))
+            glCheck(glBindBuffer(Buff::target, p_id));
+    }
+
+    static inline void gl_bind_base(GLenum p_target, GLuint p_index, GLuint p_id)
+    {
+        // glBindBufferBase binds the generic binding point of the target too.
+        gl_state_cache::current().change_buffer(p_target, p_id);
+        glCheck(glBindBufferBase(p_target, p_index, p_id));
     }
 
-    static inline void* gl_map_range(GLintptr p_offset, GLsizeiptr p_length, GLbitfield p_access)
+    static inline void gl_bind_range(GLenum p_target, GLuint p_index, GLuint p_id, GLintptr p_offset, GLsizeiptr p_size)
     {
-        return glMapBufferRange(Buff::target, p_offset, p_length, p_access);
+        // glBindBufferRange binds the generic binding point of the target too.
+        gl_state_cache::current().change_buffer(p_target, p_id);
+        glCheck(glBindBufferRange(p_target, p_index, p_id, p_offset, p_size));
     }
 
-    static inline GLboolean gl_unmap()
+    static inline void* gl_map_range(GLuint p_id, GLintptr p_offset, GLsizeiptr p_length, GLbitfield p_access)
     {
-        return glUnmapBuffer(Buff::target);
+        void* pointer = nullptr;
+        // ------------------------- DECLARE ------------------------ //
+
+        if(priv::has_direct_state_access())
+        {
+            glCheck(pointer = glMapNamedBufferRange(p_id, p_offset, p_length, p_access));
+        }
+        else
+        {
+            gl_bind(p_id);
+            glCheck(pointer = glMapBufferRange(Buff::target, p_offset, p_length, p_access));
+        }
+        return pointer;
     }
 
-    static inline GLboolean gl_unmap(GLenum target)
+    static inline GLboolean gl_unmap(GLuint p_id)
     {
-        return glUnmapBuffer(target);
+        GLboolean unmapped = GL_FALSE;
+        // ------------------------- DECLARE ------------------------ //
+
+        if(priv::has_direct_state_access())
+        {
+            glCheck(unmapped = glUnmapNamedBuffer(p_id));
+        }
+        else
+        {
+            gl_bind(p_id);
+            glCheck(unmapped = glUnmapBuffer(Buff::target));
+        }
+        return unmapped;
     }
 
-    static inline void gl_buffer_data(GLsizeiptr p_size, const GLvoid * p_data)
+    static inline void gl_buffer_data(GLuint p_id, GLsizeiptr p_size, const GLvoid * p_data)
     {
-        glCheck(glBufferData(Buff::target, p_size, p_data, Buff::usage));
+        gl_buffer_data(p_id, p_size, p_data, Buff::usage);
+    }
+
+    static inline void gl_buffer_data(GLuint p_id, GLsizeiptr p_size, const GLvoid * p_data, GLenum p_usage)
+    {
+        if(priv::has_direct_state_access())
+        {
+            glCheck(glNamedBufferData(p_id, p_size, p_data, p_usage));
+        }
+        else
+        {
+            gl_bind(p_id);
+            glCheck(glBufferData(Buff::target, p_size, p_data, p_usage));
+        }
+    }
+
+    // Requires OpenGL 4.4 or ARB_buffer_storage
+    static inline void gl_buffer_storage(GLuint p_id, GLsizeiptr p_size, const GLvoid * p_data, GLbitfield p_flags)
+    {
+        if(priv::has_direct_state_access())
+        {
+            glCheck(glNamedBufferStorage(p_id, p_size, p_data, p_flags));
+        }
+        else
+        {
+            gl_bind(p_id);
+            glCheck(glBufferStorage(Buff::target, p_size, p_data, p_flags));
+        }
+    }
+
+    static inline void gl_buffer_sub_data(GLuint p_id, GLintptr p_offset, GLsizeiptr p_size, const GLvoid * p_data)
+    {
+        if(priv::has_direct_state_access())
+        {
+            glCheck(glNamedBufferSubData(p_id, p_offset, p_size, p_data));
+        }
+        else
+        {
+            gl_bind(p_id);
+            glCheck(glBufferSubData(Buff::target, p_offset, p_size, p_data));
+        }
+    }
+
+    /**
+     * @brief Copy p_size bytes from the buffer p_read to the buffer p_write, on the GPU.
+     * Without direct state access, the buffers are bound to the copy targets.
+     */
+    static inline void gl_copy_sub_data(GLuint p_read, GLuint p_write, GLintptr p_read_offset, GLintptr p_write_offset, GLsizeiptr p_size)
+    {
+        if(priv::has_direct_state_access())
+        {
+            glCheck(glCopyNamedBufferSubData(p_read, p_write, p_read_offset, p_write_offset, p_size));
+        }
+        else
+        {
+            if(gl_state_cache::current().change_buffer(GL_COPY_READ_BUFFER, p_read))
+                glCheck(glBindBuffer(GL_COPY_READ_BUFFER, p_read));
+            if(gl_state_cache::current().change_buffer(GL_COPY_WRITE_BUFFER, p_write))
+                glCheck(glBindBuffer(GL_COPY_WRITE_BUFFER, p_write));
+            glCheck(glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, p_read_offset, p_write_offset, p_size));
+        }
     }
 
     static inline void gl_delete(GLsizei p_n, const GLuint * p_buffers)
     {
         glCheck(glDeleteBuffers(p_n, p_buffers));
+        gl_state_cache::current().deleted_buffers(p_n, p_buffers);
     }
 
     static inline void save_state()
@@ -81,7 +187,10 @@ struct gl_object_framebuffer
 {
     static inline void gl_gen(GLsizei p_n, GLuint * p_buffers)
     {
-        glCheck(glGenFramebuffers(p_n, p_buffers));
+        if(priv::has_direct_state_access())
+            glCheck(glCreateFramebuffers(p_n, p_buffers));
+        else
+            glCheck(glGenFramebuffers(p_n, p_buffers));
     }
 
     static inline void gl_delete(GLsizei p_n, const GLuint * p_buffers)
@@ -92,14 +201,43 @@ struct gl_object_framebuffer
 
 struct gl_object_texture
 {
-    static inline void gl_gen(GLsizei p_n, GLuint * p_buffers)
+    static inline void gl_gen(GLenum p_target, GLsizei p_n, GLuint * p_buffers)
     {
-        glCheck(glGenTextures(p_n, p_buffers));
+        if(priv::has_direct_state_access())
+            glCheck(glCreateTextures(p_target, p_n, p_buffers));
+        else
+            glCheck(glGenTextures(p_n, p_buffers));
     }
 
     static inline void gl_delete(GLsizei p_n, const GLuint * p_buffers)
     {
         glCheck(glDeleteTextures(p_n, p_buffers));
+        gl_state_cache::current().deleted_textures(p_n, p_buffers);
+    }
+
+    static inline void gl_active(GLuint p_unit)
+    {
+        if(gl_state_cache::current().change_active_texture(p_unit))
+            glCheck(glActiveTexture(GL_TEXTURE0 + p_unit));
+    }
+
+    /**
+     * @brief Bind the passed texture to the texture unit p_unit.
+     * Without direct state access, the active texture unit changes.
+     */
+    static inline void gl_bind(GLuint p_unit, GLenum p_target, GLuint p_id)
+    {
+        if(!gl_state_cache::current().change_texture(p_unit, p_target, p_id))
+            return;
+        if(priv::has_direct_state_access())
+        {
+            glCheck(glBindTextureUnit(p_unit, p_id));
+        }
+        else
+        {
+            gl_active(p_unit);
+            glCheck(glBindTexture(p_target, p_id));
+        }
     }
 };
 
@@ -107,7 +245,10 @@ struct gl_object_transformfeedback
 {
     static inline void gl_gen(GLsizei p_n, GLuint * p_buffers)
     {
-        glCheck(glGenTransformFeedbacks(p_n, p_buffers));
+        if(priv::has_direct_state_access())
+            glCheck(glCreateTransformFeedbacks(p_n, p_buffers));
+        else
+            glCheck(glGenTransformFeedbacks(p_n, p_buffers));
     }
 
     static inline void gl_delete(GLsizei p_n, const GLuint * p_buffers)
@@ -120,17 +261,130 @@ struct gl_object_vertexarrays
 {
     static inline void gl_gen(GLsizei p_n, GLuint * p_vao)
     {
-        glCheck(glGenVertexArrays(p_n, p_vao));
+        if(priv::has_direct_state_access())
+            glCheck(glCreateVertexArrays(p_n, p_vao));
+        else
+            glCheck(glGenVertexArrays(p_n, p_vao));
     }
 
     static inline void gl_delete(GLsizei p_n, const GLuint * p_vao)
     {
         glCheck(glDeleteVertexArrays(p_n, p_vao));
+        gl_state_cache::current().deleted_vaos(p_n, p_vao);
     }
 
     static inline void gl_bind(GLuint p_vao)
     {
-        glCheck(glBindVertexArray(p_vao));
+        if(gl_state_cache::current().change_vao(p_vao))
+            glCheck(glBindVertexArray(p_vao));
+    }
+
+    static inline void gl_enable_attrib(GLuint p_location)
+    {
+        glCheck(glEnableVertexAttribArray(p_location));
+    }
+
+    static inline void gl_disable_attrib(GLuint p_location)
+    {
+        glCheck(glDisableVertexAttribArray(p_location));
+    }
+
+    /*
+     * The attributes are specified as the shaders read them: integer types not normalized
+     * (see attribute_normalized) go through the I variant, doubles through the L variant,
+     * the others are converted to float. Without OpenGL 4.1 or ARB_vertex_attrib_64bit,
+     * the doubles are converted to float too.
+     */
+
+    static inline void gl_attrib_pointer(GLuint p_location, GLint p_size, GLenum p_type, GLboolean p_normalized,
+                                         GLsizei p_stride, const GLvoid* p_offset)
+    {
+        if(priv::is_integer_component(p_type) && !p_normalized)
+            glCheck(glVertexAttribIPointer(p_location, p_size, p_type, p_stride, p_offset));
+        else if(priv::is_double_component(p_type) && priv::has_vertex_attrib_64bit())
+            glCheck(glVertexAttribLPointer(p_location, p_size, p_type, p_stride, p_offset));
+        else
+            glCheck(glVertexAttribPointer(p_location, p_size, p_type, p_normalized, p_stride, p_offset));
+    }
+
+    static inline void gl_attrib_divisor(GLuint p_location, GLuint p_divisor)
+    {
+        glCheck(glVertexAttribDivisor(p_location, p_divisor));
+    }
+
+    // Requires OpenGL 4.3 or ARB_vertex_attrib_binding
+    static inline void gl_attrib_format(GLuint p_location, GLint p_size, GLenum p_type, GLboolean p_normalized, GLuint p_relative_offset)
+    {
+        if(priv::is_integer_component(p_type) && !p_normalized)
+            glCheck(glVertexAttribIFormat(p_location, p_size, p_type, p_relative_offset));
+        else if(priv::is_double_component(p_type) && priv::has_vertex_attrib_64bit())
+            glCheck(glVertexAttribLFormat(p_location, p_size, p_type, p_relative_offset));
+        else
+            glCheck(glVertexAttribFormat(p_location, p_size, p_type, p_normalized, p_relative_offset));
+    }
+
+    // Requires OpenGL 4.3 or ARB_vertex_attrib_binding
+    static inline void gl_attrib_binding(GLuint p_location, GLuint p_binding)
+    {
+        glCheck(glVertexAttribBinding(p_location, p_binding));
+    }
+
+    // Requires OpenGL 4.3 or ARB_vertex_attrib_binding
+    static inline void gl_binding_divisor(GLuint p_binding, GLuint p_divisor)
+    {
+        glCheck(glVertexBindingDivisor(p_binding, p_divisor));
+    }
+
+    // Requires OpenGL 4.3 or ARB_vertex_attrib_binding
+    static inline void gl_bind_vertex_buffer(GLuint p_binding, GLuint p_buffer, GLintptr p_offset, GLsizei p_stride)
+    {
+        glCheck(glBindVertexBuffer(p_binding, p_buffer, p_offset, p_stride));
+    }
+
+    /*
+     * Same as above but on the passed vao without binding it.
+     * Requires OpenGL 4.5 or ARB_direct_state_access.
+     */
+
+    static inline void gl_enable_attrib(GLuint p_vao, GLuint p_location)
+    {
+        glCheck(glEnableVertexArrayAttrib(p_vao, p_location));
+    }
+
+    static inline void gl_disable_attrib(GLuint p_vao, GLuint p_location)
+    {
+        glCheck(glDisableVertexArrayAttrib(p_vao, p_location));
+    }
+
+    static inline void gl_attrib_format(GLuint p_vao, GLuint p_location, GLint p_size, GLenum p_type, GLboolean p_normalized, GLuint p_relative_offset)
+    {
+        if(priv::is_integer_component(p_type) && !p_normalized)
+            glCheck(glVertexArrayAttribIFormat(p_vao, p_location, p_size, p_type, p_relative_offset));
+        else if(priv::is_double_component(p_type) && priv::has_vertex_attrib_64bit())
+            glCheck(glVertexArrayAttribLFormat(p_vao, p_location, p_size, p_type, p_relative_offset));
+        else
+            glCheck(glVertexArrayAttribFormat(p_vao, p_location, p_size, p_type, p_normalized, p_relative_offset));
+    }
+
+    static inline void gl_attrib_binding(GLuint p_vao, GLuint p_location, GLuint p_binding)
+    {
+        glCheck(glVertexArrayAttribBinding(p_vao, p_location, p_binding));
+    }
+
+    static inline void gl_binding_divisor(GLuint p_vao, GLuint p_binding, GLuint p_divisor)
+    {
+        glCheck(glVertexArrayBindingDivisor(p_vao, p_binding, p_divisor));
+    }
+
+    static inline void gl_bind_vertex_buffer(GLuint p_vao, GLuint p_binding, GLuint p_buffer, GLintptr p_offset, GLsizei p_stride)
+    {
+        glCheck(glVertexArrayVertexBuffer(p_vao, p_binding, p_buffer, p_offset, p_stride));
+    }
+
+    static inline void gl_element_buffer(GLuint p_vao, GLuint p_buffer)
+    {
+        gl_state_cache::current().change_vao_element_buffer(p_vao, p_buffer);
+        glCheck(glVertexArrayElementBuffer(p_vao, p_buffer));
     }
 };
 
@@ -141,23 +395,32 @@ struct gl_object_sampler
 {
     static inline void gl_gen(GLsizei p_n, GLuint* p_samplers)
     {
-        glCheck(glGenSamplers(p_n, p_samplers));
+        if(priv::has_direct_state_access())
+            glCheck(glCreateSamplers(p_n, p_samplers));
+        else
+            glCheck(glGenSamplers(p_n, p_samplers));
     }
 
     static inline void gl_delete(GLsizei p_n, const GLuint* p_samplers)
     {
         glCheck(glDeleteSamplers(p_n, p_samplers));
+        gl_state_cache::current().deleted_samplers(p_n, p_samplers);
     }
 
     static inline void gl_bind(GLuint p_texture_unit, GLuint p_sampler_id)
     {
-        glCheck(glBindSampler(p_texture_unit, p_sampler_id));
+        if(gl_state_cache::current().change_sampler(p_texture_unit, p_sampler_id))
+            glCheck(glBindSampler(p_texture_unit, p_sampler_id));
     }
 
     // Requires OpenGL 4.4
     static inline void gl_bind_all(GLuint p_first_texture_unit, GLsizei p_count, const GLuint* p_samplers)
     {
-        glCheck(glBindSamplers(p_first_texture_unit, p_count, p_samplers));
+        bool changed = false;
+        for(GLsizei i = 0; i < p_count; ++i)
+            changed = gl_state_cache::current().change_sampler(p_first_texture_unit + i, p_samplers[i]) || changed;
+        if(changed)
+            glCheck(glBindSamplers(p_first_texture_unit, p_count, p_samplers));
     }
 };
 
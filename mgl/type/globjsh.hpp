@@ -9,6 +9,7 @@
 #define GLOBJSH_HPP_
 
 #include <string>
+#include "glstatecache.hpp"
 
 namespace mgl {
 
@@ -31,7 +32,10 @@ struct gl_object_program
     static inline void gl_delete(GLsizei p_n, const GLuint * p_buffers)
     {
         for(int i = 0; i < p_n; ++i)
+        {
+            gl_state_cache::current().deleted_program(p_buffers[i]);
             glDeleteProgram(p_buffers[i]);
+        }
     }
 
     /**
@@ -40,7 +44,26 @@ struct gl_object_program
      */
     static inline void gl_use(GLuint p_id)
     {
-        glCheck(glUseProgram(p_id));
+        if(gl_state_cache::current().change_program(p_id))
+            glCheck(glUseProgram(p_id));
+    }
+
+    /**
+     * @brief Launch the compute shader of the program in use.
+     * @param p_x, p_y, p_z are the numbers of work groups.
+     */
+    static inline void gl_dispatch_compute(GLuint p_x, GLuint p_y, GLuint p_z)
+    {
+        glCheck(glDispatchCompute(p_x, p_y, p_z));
+    }
+
+    /**
+     * @brief Order the memory writes of the shaders before the reads allowed by p_barriers.
+     * @param p_barriers is a combination of GL_*_BARRIER_BIT.
+     */
+    static inline void gl_memory_barrier(GLbitfield p_barriers)
+    {
+        glCheck(glMemoryBarrier(p_barriers));
     }
 
     /**
@@ -74,6 +97,69 @@ struct gl_object_program
         return loc;
     }
 
+    /**
+     * @brief Associate a location to an attribute, takes effect at the next link.
+     * @param p_program_id is the id of the program.
+     * @param p_location is the location of the attribute.
+     * @param p_name is the name of the attribute.
+     */
+    static inline void gl_bind_attrib_location(GLuint p_program_id, GLuint p_location, const char * p_name)
+    {
+        glCheck(glBindAttribLocation(p_program_id, p_location, p_name));
+    }
+
+    /**
+     * @brief Returns the location of the passed attribute.
+     * @param p_program_id is the id of the program.
+     * @param p_name is the name of the attribute.
+     * @return Returns the location or -1 if the attribute isn't active.
+     */
+    static inline GLint gl_attrib_location(GLuint p_program_id, const char * p_name)
+    {
+        GLint loc;
+        glCheck(loc = glGetAttribLocation(p_program_id, p_name));
+        return loc;
+    }
+
+    /**
+     * @brief Returns the number of active attributes of the program.
+     * @param p_program_id is the id of the program.
+     */
+    static inline GLint gl_active_attributes(GLuint p_program_id)
+    {
+        GLint count = 0;
+        glCheck(glGetProgramiv(p_program_id, GL_ACTIVE_ATTRIBUTES, &count));
+        return count;
+    }
+
+    /**
+     * @brief Returns the length of the longest active attribute name, null character included.
+     * @param p_program_id is the id of the program.
+     */
+    static inline GLint gl_active_attribute_max_length(GLuint p_program_id)
+    {
+        GLint length = 0;
+        glCheck(glGetProgramiv(p_program_id, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH, &length));
+        return length;
+    }
+
+    /**
+     * @brief Retrieve the name of the active attribute at p_index.
+     * @param p_program_id is the id of the program.
+     * @param p_index is the index of the active attribute.
+     * @param p_buf_size is the size of p_name.
+     * @param p_name receives the name of the attribute.
+     * @return Returns the length of the name, without the null character.
+     */
+    static inline GLsizei gl_active_attribute(GLuint p_program_id, GLuint p_index, GLsizei p_buf_size, GLchar * p_name)
+    {
+        GLsizei length = 0;
+        GLint   size;
+        GLenum  type;
+        glCheck(glGetActiveAttrib(p_program_id, p_index, p_buf_size, &length, &size, &type, p_name));
+        return length;
+    }
+
     /**
      * @brief Test the link status of the specified program.
      * @param p_program_id is the id of the program.
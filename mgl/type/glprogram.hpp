@@ -17,10 +17,31 @@
 #include "../meta/glmhelper.hpp"
 #include "../meta/gluniformhelpers.hpp"
 #include "gluniform.hpp"
+#include "glattributelocations.hpp"
+#include "../meta/gliterdata.hpp"
 #include "priv/details.hpp"
 
 namespace mgl {
 
+namespace priv {
+
+/**
+ * Functor binding each attribute of T to its compile-time location.
+ */
+template<typename T>
+struct bind_location_helper
+{
+    template<typename E, std::size_t N>
+    void apply(const char* p_name) const
+    {
+        gl_object_program::gl_bind_attrib_location(m_program_id, gl_vertex_layout<T>::location(N), p_name);
+    }
+
+    gl_types::uid m_program_id;
+};
+
+}  /* namespace priv */
+
 /**
  * @ingroup shader
  * @brief gl_program is a wrapper for an opengl shader program.
@@ -87,6 +108,26 @@ struct gl_program : public priv::base_id_ref_count
             else
                 detach_shaders();
         }
+        // Reflect the active attributes once, so that vao creation doesn't query them.
+        m_attribute_locations.reflect(id);
+    }
+
+    /**
+     * @brief Bind the attributes of T to their compile-time locations.
+     *
+     * Must be called before link(). Every program consuming T then uses the same
+     * locations, so a vao created with mgl::make_vao() can be shared between them.
+     * @see attribute_location
+     */
+    template<typename T>
+    void bind_attribute_locations()
+    {
+        static_assert(priv::is_gl_attributes<T>::value, "T must be declared with MGL_DEFINE_GL_ATTRIBUTES.");
+        // ------------------------- DECLARE ------------------------ //
+
+        this->ensure_created();
+        priv::bind_location_helper<T> helper{id()};
+        mgl::for_each<T>::apply(helper);
     }
 
     /**
@@ -97,6 +138,17 @@ struct gl_program : public priv::base_id_ref_count
         gl_object_program::gl_use(id());
     }
 
+    /**
+     * @brief Use this program and launch its compute shader.
+     * @param p_x, p_y, p_z are the numbers of work groups.
+     * @see gl_object_program::gl_memory_barrier to read the results.
+     */
+    void dispatch(GLuint p_x, GLuint p_y = 1, GLuint p_z = 1) const
+    {
+        use();
+        gl_object_program::gl_dispatch_compute(p_x, p_y, p_z);
+    }
+
     /**
      * @brief Attach the passed shader to this program.
      * @param p_rhs is the shader to attach
@@ -131,6 +183,20 @@ struct gl_program : public priv::base_id_ref_count
         return gl_uniform(gl_object_program::gl_uniform_location(id(), p_name));
     }
 
+    /**
+     * @brief Returns the locations of the active attributes of this program.
+     *
+     * The table is filled by link(). Copies of a program made before
+     * the link fill their own table the first time it is needed.
+     * @return Returns the attribute table.
+     */
+    const gl_attribute_locations& attribute_locations() const
+    {
+        if(!m_attribute_locations.is_reflected() && id() && gl_object_program::gl_link_status(id()))
+            m_attribute_locations.reflect(id());
+        return m_attribute_locations;
+    }
+
     /**
      * @brief This method allows to create a vao based on this program.
      * @param p_buffers is the buffers that are gonna be part of this vao.
@@ -139,7 +205,7 @@ struct gl_program : public priv::base_id_ref_count
     template<typename... T>
     gl_vao make_vao(T&&... p_buffers) const
     {
-        return gl_vao(id(), std::forward<T>(p_buffers)...);
+        return gl_vao(nullptr, &attribute_locations(), std::forward<T>(p_buffers)...);
     }
 
     /**
@@ -231,6 +297,8 @@ private:
     // ================================================================ //
 
     gl_shader m_attached_shaders[static_cast<std::size_t>(shader_type::Count)];
+    /** Locations of the active attributes, filled at link time. */
+    mutable gl_attribute_locations m_attribute_locations;
 };
 
 
@@ -0,0 +1,395 @@
+/*
+ * glstatecache.hpp
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: nemikolh
+ */
+
+#ifndef MGL_TYPE_GLSTATECACHE_HPP_
+#define MGL_TYPE_GLSTATECACHE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <cassert>
+#include "../glrequires.hpp"
+
+namespace mgl {
+
+/**
+ * @brief gl_state_cache is a shadow of the objects bound to an OpenGL context.
+ *
+ * The wrappers of globj.hpp and globjsh.hpp consult it before binding a program, a vao,
+ * a buffer, a texture or a sampler, and skip the call when the object is already bound.
+ * Deleted objects are forgotten, since OpenGL unbinds them and may reuse their names.
+ *
+ * The filtering is opt-in, since the cache can't see the context switches nor the binds done
+ * without mgl. Until a cache is made current, current() returns a cache of the thread which
+ * issues every call and only counts them. The application owns one cache per context and makes
+ * it current along with the context:
+ *  @code
+ *      mgl::gl_state_cache cache;
+ *      window.setActive(true);
+ *      cache.make_current();
+ *      ...
+ *      // Back from a library binding objects on its own.
+ *      cache.invalidate();
+ *  @endcode
+ * The cache must stay current while its context is, reset_current() goes back to the
+ * unfiltered binds, before destroying the cache for instance.
+ *
+ * Define MGL_NO_STATE_CACHE to issue every call; the counters are still maintained.
+ */
+class gl_state_cache
+{
+public:
+    // ================================================================ //
+    // =========================== CTOR/DTOR ========================== //
+    // ================================================================ //
+
+    /**
+     * @brief Constructor.
+     * @param p_filter is false for a cache issuing every call, as the default one of each thread.
+     */
+    explicit gl_state_cache(bool p_filter = true)
+        : m_filter(p_filter)
+        , m_issued(0)
+        , m_skipped(0)
+    {
+        invalidate();
+    }
+
+    gl_state_cache(const gl_state_cache&) = delete;
+    gl_state_cache& operator=(const gl_state_cache&) = delete;
+
+    // ================================================================ //
+    // ======================== STATIC METHODS ======================== //
+    // ================================================================ //
+
+    /**
+     * @brief Returns the cache of the context current on this thread.
+     */
+    static gl_state_cache& current()
+    {
+        return *current_ptr();
+    }
+
+    /**
+     * @brief Make the default cache of the thread current again, every call is then issued.
+     */
+    static void reset_current()
+    {
+        current_ptr() = &default_instance();
+    }
+
+    // ================================================================ //
+    // ============================ METHODS =========================== //
+    // ================================================================ //
+
+    /**
+     * @brief Make this cache the one of the calling thread.
+     */
+    void make_current()
+    {
+        current_ptr() = this;
+    }
+
+    /**
+     * @brief Forget everything, the next binds are all issued.
+     */
+    void invalidate()
+    {
+        m_program        = unknown;
+        m_vao            = unknown;
+        m_active_texture = unknown;
+        for(GLuint& slot : m_buffers)
+            slot = unknown;
+        for(texture_slot& slot : m_textures)
+            slot = texture_slot{0, unknown};
+        for(GLuint& slot : m_samplers)
+            slot = unknown;
+    }
+
+    /**
+     * @brief Record the use of the passed program.
+     * @return Returns true if glUseProgram must be called.
+     */
+    bool change_program(GLuint p_id)
+    {
+        return filter(m_program, p_id);
+    }
+
+    /**
+     * @brief Record the bind of the passed vao.
+     * @return Returns true if glBindVertexArray must be called.
+     */
+    bool change_vao(GLuint p_id)
+    {
+        if(!filter(m_vao, p_id))
+            return false;
+        // The element buffer binding is part of the vao state.
+        m_buffers[buffer_index(GL_ELEMENT_ARRAY_BUFFER)] = unknown;
+        return true;
+    }
+
+    /**
+     * @brief Record the element buffer set on a vao with direct state access.
+     */
+    void change_vao_element_buffer(GLuint p_vao, GLuint p_id)
+    {
+        // Only the element buffer of the bound vao is tracked.
+        if(p_vao == m_vao)
+            m_buffers[buffer_index(GL_ELEMENT_ARRAY_BUFFER)] = p_id;
+    }
+
+    /**
+     * @brief Record the bind of a buffer to the passed target.
+     * @return Returns true if glBindBuffer must be called.
+     */
+    bool change_buffer(GLenum p_target, GLuint p_id)
+    {
+        const std::size_t index = buffer_index(p_target);
+        // ------------------------- DECLARE ------------------------ //
+
+        if(index == max_buffer_targets)
+            return filter_untracked();
+        return filter(m_buffers[index], p_id);
+    }
+
+    /**
+     * @brief Record the active texture unit.
+     * @return Returns true if glActiveTexture must be called.
+     */
+    bool change_active_texture(GLuint p_unit)
+    {
+        return filter(m_active_texture, p_unit);
+    }
+
+    /**
+     * @brief Record the bind of a texture to the passed unit.
+     * @return Returns true if the texture must be bound.
+     */
+    bool change_texture(GLuint p_unit, GLenum p_target, GLuint p_id)
+    {
+        if(p_unit >= max_units)
+            return filter_untracked();
+        texture_slot& slot = m_textures[p_unit];
+        if(slot.target != p_target)
+        {
+            slot = texture_slot{p_target, p_id};
+            return filter_untracked();
+        }
+        return filter(slot.id, p_id);
+    }
+
+    /**
+     * @brief Record the bind of a sampler to the passed unit.
+     * @return Returns true if glBindSampler must be called.
+     */
+    bool change_sampler(GLuint p_unit, GLuint p_id)
+    {
+        if(p_unit >= max_units)
+            return filter_untracked();
+        return filter(m_samplers[p_unit], p_id);
+    }
+
+    /**
+     * @brief Forget the passed buffers, unbound by glDeleteBuffers.
+     */
+    void deleted_buffers(GLsizei p_n, const GLuint* p_ids)
+    {
+        for(GLsizei i = 0; i < p_n; ++i)
+            for(GLuint& slot : m_buffers)
+                if(slot == p_ids[i])
+                    slot = 0;
+    }
+
+    /**
+     * @brief Forget the passed program, deleted by glDeleteProgram.
+     *
+     * A program in use is only deleted when another one is used, its name may then be reused:
+     * the next use is always issued.
+     */
+    void deleted_program(GLuint p_id)
+    {
+        if(m_program == p_id)
+            m_program = unknown;
+    }
+
+    /**
+     * @brief Forget the passed vao, unbound by glDeleteVertexArrays.
+     */
+    void deleted_vaos(GLsizei p_n, const GLuint* p_ids)
+    {
+        for(GLsizei i = 0; i < p_n; ++i)
+        {
+            if(m_vao == p_ids[i])
+            {
+                m_vao = 0;
+                m_buffers[buffer_index(GL_ELEMENT_ARRAY_BUFFER)] = unknown;
+            }
+        }
+    }
+
+    /**
+     * @brief Forget the passed textures, unbound by glDeleteTextures.
+     */
+    void deleted_textures(GLsizei p_n, const GLuint* p_ids)
+    {
+        for(GLsizei i = 0; i < p_n; ++i)
+            for(texture_slot& slot : m_textures)
+                if(slot.id == p_ids[i])
+                    slot.id = 0;
+    }
+
+    /**
+     * @brief Forget the passed samplers, unbound by glDeleteSamplers.
+     */
+    void deleted_samplers(GLsizei p_n, const GLuint* p_ids)
+    {
+        for(GLsizei i = 0; i < p_n; ++i)
+            for(GLuint& slot : m_samplers)
+                if(slot == p_ids[i])
+                    slot = 0;
+    }
+
+    /**
+     * @brief Returns the number of calls issued to the driver.
+     */
+    std::size_t issued() const
+    {
+        return m_issued;
+    }
+
+    /**
+     * @brief Returns the number of redundant calls skipped.
+     */
+    std::size_t skipped() const
+    {
+        return m_skipped;
+    }
+
+    /**
+     * @brief Reset the counters, at the start of a frame for instance.
+     */
+    void reset_counters()
+    {
+        m_issued  = 0;
+        m_skipped = 0;
+    }
+
+private:
+
+    // ================================================================ //
+    // ============================= TYPES ============================ //
+    // ================================================================ //
+
+    struct texture_slot
+    {
+        GLenum target;
+        GLuint id;
+    };
+
+    /** Value of a slot whose binding isn't known. */
+    static constexpr GLuint      unknown   = ~GLuint(0);
+    /** Number of texture units tracked. */
+    static constexpr std::size_t max_units = 32;
+    /** Number of buffer targets tracked, see buffer_index. */
+    static constexpr std::size_t max_buffer_targets = 15;
+
+    // ================================================================ //
+    // ======================== STATIC METHODS ======================== //
+    // ================================================================ //
+
+    static gl_state_cache& default_instance()
+    {
+        static thread_local gl_state_cache instance(false);
+        return instance;
+    }
+
+    static gl_state_cache*& current_ptr()
+    {
+        static thread_local gl_state_cache* current = &default_instance();
+        return current;
+    }
+
+    // ================================================================ //
+    // ============================ METHODS =========================== //
+    // ================================================================ //
+
+    bool filter(GLuint& p_slot, GLuint p_id)
+    {
+#       ifndef MGL_NO_STATE_CACHE
+        if(m_filter && p_slot == p_id)
+        {
+            ++m_skipped;
+            return false;
+        }
+#       endif
+        p_slot = p_id;
+        ++m_issued;
+        return true;
+    }
+
+    bool filter_untracked()
+    {
+        ++m_issued;
+        return true;
+    }
+
+    /*
+     * Returns the slot of the passed buffer target, max_buffer_targets for an unknown target.
+     */
+    static std::size_t buffer_index(GLenum p_target)
+    {
+        switch(p_target)
+        {
+        case GL_ARRAY_BUFFER:               return 0;
+        case GL_ELEMENT_ARRAY_BUFFER:       return 1;
+        case GL_UNIFORM_BUFFER:             return 2;
+        case GL_SHADER_STORAGE_BUFFER:      return 3;
+        case GL_DRAW_INDIRECT_BUFFER:       return 4;
+        case GL_DISPATCH_INDIRECT_BUFFER:   return 5;
+        case GL_COPY_READ_BUFFER:           return 6;
+        case GL_COPY_WRITE_BUFFER:          return 7;
+        case GL_PIXEL_PACK_BUFFER:          return 8;
+        case GL_PIXEL_UNPACK_BUFFER:        return 9;
+        case GL_TEXTURE_BUFFER:             return 10;
+        case GL_TRANSFORM_FEEDBACK_BUFFER:  return 11;
+        case GL_ATOMIC_COUNTER_BUFFER:      return 12;
+        case GL_QUERY_BUFFER:               return 13;
+        case GL_PARAMETER_BUFFER_ARB:       return 14;
+        default:
+#           ifndef MGL_NDEBUG
+            assert(false && "Unknown buffer target.");
+#           endif
+            return max_buffer_targets;
+        }
+    }
+
+    // ================================================================ //
+    // ============================= FIELDS =========================== //
+    // ================================================================ //
+
+    /** False when every call is issued. */
+    bool         m_filter;
+    /** The program in use. */
+    GLuint       m_program;
+    /** The vao bound. */
+    GLuint       m_vao;
+    /** The active texture unit. */
+    GLuint       m_active_texture;
+    /** The buffer bound per target, see buffer_index. */
+    GLuint       m_buffers[max_buffer_targets];
+    /** The texture bound per unit. */
+    texture_slot m_textures[max_units];
+    /** The sampler bound per unit. */
+    GLuint       m_samplers[max_units];
+    /** Number of calls issued. */
+    std::size_t  m_issued;
+    /** Number of calls skipped. */
+    std::size_t  m_skipped;
+};
+
+}  /* namespace mgl */
+
+#endif /* MGL_TYPE_GLSTATECACHE_HPP_ */
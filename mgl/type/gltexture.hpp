@@ -78,6 +78,24 @@ struct gl_texture : public priv::base_id_ref_count
     // ============================ METHODS =========================== //
     // ================================================================ //
 
+    /**
+     * @brief Create the OpenGL texture when it doesn't exist yet.
+     * Its storage is left to the caller, through the id().
+     */
+    void create()
+    {
+        ensure_created();
+    }
+
+    /**
+     * @brief Bind the texture to the given texture unit.
+     * @param p_texture_unit is the texture unit.
+     */
+    void bind(GLuint p_texture_unit) const
+    {
+        gl_object_texture::gl_bind(p_texture_unit, Kind::target, id());
+    }
+
 private:
 
     // ================================================================ //
@@ -87,7 +105,7 @@ private:
     gl_types::uid gen() override
     {
         gl_types::uid id;
-        gl_object_texture::gl_gen(1, &id);
+        gl_object_texture::gl_gen(Kind::target, 1, &id);
         return id;
     }
 
@@ -87,11 +87,26 @@ struct priv_gl_buffer<T, true>
  *          gl_vector<T, MyBufferSpec>
  *      @endcode
  *
+ * The usage of an adaptive gl_vector is only its initial hint, see gl_upload_policy.
  */
 template<class T>
 struct gl_buffer_type : public priv::priv_gl_buffer<T>
 {};
 
+/**
+ * @brief A buffer specification for an explicit target, to reach its binding point
+ * whatever the type of the elements:
+ *      @code
+ *          mgl::gl_object_buffer<mgl::gl_buffer_target<GL_ARRAY_BUFFER>>::gl_bind(id);
+ *      @endcode
+ */
+template<GLenum Target, GLenum Usage = GL_DYNAMIC_DRAW>
+struct gl_buffer_target
+{
+    static constexpr GLenum target = Target;
+    static constexpr GLenum usage  = Usage;
+};
+
 // -----------------------------------------------------------------------------------------------------------------------------------//
 // -----------------------------------------------------------------------------------------------------------------------------------//
 
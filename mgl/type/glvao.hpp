@@ -11,10 +11,14 @@
 #include <utility>
 #include <type_traits>
 #include <tuple>
+#include <vector>
+#include <algorithm>
+#include <limits>
 #include <cassert>
 #include "gltraits.hpp"
 #include "../glexceptions.hpp"
 #include "../meta/glbindbuffer.hpp"
+#include "glvaopool.hpp"
 
 namespace mgl {
 
@@ -49,6 +53,15 @@ class gl_vector;
  *      // Draw the vao
  *      mgl::gl_draw(my_vao, my_material);
  *  @endcode
+ *
+ * When one of the gl_vector passed moves to a new OpenGL buffer (after a push_back past its
+ * capacity for instance), only that buffer is attached again, the next time the vao is bound.
+ * The vao follows the vectors through a state they own (see gl_vector::track), never through
+ * a reference, and keeps the attribute locations resolved when it is made: neither the vectors
+ * nor the program have to outlive it.
+ *
+ * The vao follows a vector when it is moved, not when it is copied. Once a vector is destroyed,
+ * its buffer counts for no element in size() and size_instanced().
  */
 struct gl_vao
 {
@@ -56,13 +69,58 @@ struct gl_vao
     // =========================== CTOR/DTOR ========================== //
     // ================================================================ //
 
-    gl_vao() = default;
-    gl_vao(gl_vao&&) = default;
-    gl_vao& operator=(gl_vao&&) = default;
+    gl_vao()
+        : m_id{0}
+        , m_elements_type{0}
+        , m_size{0}
+        , m_size_instanced{0}
+        , m_enabled{0}
+        , m_base_instance{0}
+        , m_pool{nullptr}
+    {}
+
+    gl_vao(gl_vao&& p_rhs)
+        : m_id{p_rhs.m_id}
+        , m_elements_type{p_rhs.m_elements_type}
+        , m_size{p_rhs.m_size}
+        , m_size_instanced{p_rhs.m_size_instanced}
+        , m_enabled{p_rhs.m_enabled}
+        , m_base_instance{p_rhs.m_base_instance}
+        , m_pool{p_rhs.m_pool}
+        , m_bindings(std::move(p_rhs.m_bindings))
+    {
+        p_rhs.m_id = 0;
+    }
+
+    gl_vao& operator=(gl_vao&& p_rhs)
+    {
+        if(this != &p_rhs)
+        {
+            release();
+            m_id             = p_rhs.m_id;
+            m_elements_type  = p_rhs.m_elements_type;
+            m_size           = p_rhs.m_size;
+            m_size_instanced = p_rhs.m_size_instanced;
+            m_enabled        = p_rhs.m_enabled;
+            m_base_instance  = p_rhs.m_base_instance;
+            m_pool           = p_rhs.m_pool;
+            m_bindings       = std::move(p_rhs.m_bindings);
+            p_rhs.m_id = 0;
+        }
+        return *this;
+    }
 
     gl_vao(const gl_vao&) = delete;
     const gl_vao& operator=(const gl_vao&) = delete;
 
+    /**
+     * @brief Delete the vao, or give it back to its pool.
+     */
+    ~gl_vao()
+    {
+        release();
+    }
+
     // ================================================================ //
     // ============================ METHODS =========================== //
     // ================================================================ //
@@ -75,6 +133,42 @@ struct gl_vao
         if(!m_id)
             throw gl_uninitialized_buffer();
         gl_object_vertexarrays::gl_bind(m_id);
+        refresh();
+    }
+
+    /**
+     * @brief Attach again the buffers that have changed of OpenGL buffer since the last bind.
+     * Called by bind(). Without direct state access, the vao must be bound.
+     */
+    void refresh() const
+    {
+        for(priv::vao_binding& binding : m_bindings)
+        {
+            const priv::gl_buffer_track& track = *binding.track;
+            if(track.owner && track.generation(track.owner) != binding.bound_generation)
+                binding.attach(priv::has_direct_state_access() ? m_id : 0, m_base_instance);
+        }
+    }
+
+    /**
+     * @brief Make the instanced buffers start at the passed instance.
+     *
+     * This is the fallback for the draws with a base instance when GL 4.2 or ARB_base_instance
+     * is missing: the instanced attributes are attached again with an offset, the other buffers
+     * are left untouched. Nothing is done when the offset doesn't change.
+     * Without direct state access, the vao must be bound.
+     * @param p_base_instance is the first instance of the instanced buffers.
+     */
+    void offset_instances(std::size_t p_base_instance) const
+    {
+        if(p_base_instance == m_base_instance)
+            return;
+        m_base_instance = p_base_instance;
+        for(priv::vao_binding& binding : m_bindings)
+        {
+            if(binding.type == priv::vao_binding::kind::instanced)
+                binding.attach(priv::has_direct_state_access() ? m_id : 0, m_base_instance);
+        }
     }
 
     /**
@@ -86,12 +180,29 @@ struct gl_vao
     }
 
     /**
-     * @brief Returns the size of the buffers containing per attribute data.
+     * @brief Returns the vao id, 0 if the vao is empty.
+     */
+    gl_types::uid id() const
+    {
+        return m_id;
+    }
+
+    /**
+     * @brief Returns the number of elements to draw: the number of indices when
+     * the vao has an element buffer, the number of vertices otherwise.
      * @return Returns the size of the buffers.
      */
     std::size_t size() const
     {
-        return m_size;
+        std::size_t vertices = m_bindings.empty() ? m_size : std::numeric_limits<std::size_t>::max();
+        for(const priv::vao_binding& binding : m_bindings)
+        {
+            if(binding.type == priv::vao_binding::kind::elements)
+                return binding.size();
+            if(binding.type == priv::vao_binding::kind::vertices)
+                vertices = std::min(vertices, binding.size());
+        }
+        return vertices == std::numeric_limits<std::size_t>::max() ? 0 : vertices;
     }
 
     /**
@@ -100,7 +211,33 @@ struct gl_vao
      */
     std::size_t size_instanced() const
     {
-        return m_size_instanced;
+        // The recorded buffers may have grown since the creation of the vao.
+        std::size_t size = m_bindings.empty() ? m_size_instanced : std::numeric_limits<std::size_t>::max();
+        for(const priv::vao_binding& binding : m_bindings)
+            if(binding.type == priv::vao_binding::kind::instanced)
+                size = std::min(size, binding.size() * binding.divisor);
+        return size;
+    }
+
+    /**
+     * @brief Returns true if every instanced buffer has data for the passed instances.
+     *
+     * The instance i reads the element base + i / divisor of a buffer, hence a buffer
+     * must hold base + ceil(count / divisor) elements.
+     * @param p_count is the number of instances.
+     * @param p_base_instance is the first instance.
+     */
+    bool covers_instances(std::size_t p_count, std::size_t p_base_instance) const
+    {
+        if(m_bindings.empty())
+            return m_size_instanced == 0 || m_size_instanced >= p_count + p_base_instance;
+        for(const priv::vao_binding& binding : m_bindings)
+        {
+            if(binding.type == priv::vao_binding::kind::instanced
+               && binding.size() < p_base_instance + (p_count + binding.divisor - 1) / binding.divisor)
+                return false;
+        }
+        return true;
     }
 
     /**
@@ -120,16 +257,21 @@ private:
 
     /**
      * @brief Constructor.
+     * @param p_pool is the pool providing the vao name, or null.
+     * @param p_locations is the attribute table of the program, null to use the compile-time locations.
      * @param p_vs is the list of gl_vector that we want to associate with this vao.
      */
     template<typename... Arg>
-    gl_vao(gl_types::uid p_program_id, Arg&&... p_vs)
+    gl_vao(gl_vao_pool* p_pool, const gl_attribute_locations* p_locations, Arg&&... p_vs)
         : m_id{0}
         , m_elements_type{0}
         , m_size{0}
         , m_size_instanced{0}
+        , m_enabled{0}
+        , m_base_instance{0}
+        , m_pool{p_pool}
     {
-        unpack(p_program_id, std::forward<Arg>(p_vs)...);
+        unpack(p_locations, std::forward<Arg>(p_vs)...);
     }
 
     // ================================================================ //
@@ -137,22 +279,64 @@ private:
     // ================================================================ //
 
     friend gl_program;
+    template<typename... T>
+    friend gl_vao make_vao(T&&... p_buffers);
+    template<typename... T>
+    friend gl_vao make_vao(gl_vao_pool& p_pool, T&&... p_buffers);
 
     // ================================================================ //
     // ============================ METHODS =========================== //
     // ================================================================ //
 
     template<typename... Arg>
-    void unpack(gl_types::uid p_program_id, Arg&&... p_args)
+    void unpack(const gl_attribute_locations* p_locations, Arg&&... p_args)
+    {
+        // Generate a new vao object:
+        if(m_pool)
+            m_id = m_pool->acquire();
+        else
+            gl_object_vertexarrays::gl_gen(1, &m_id);
+        gl_bind_buffers binder = p_locations ? gl_bind_buffers(*p_locations) : gl_bind_buffers();
+        binder.record_to(m_bindings, m_enabled);
+        try
+        {
+            if(priv::has_direct_state_access())
+            {
+                // Edit the vao by name, nothing is bound.
+                std::tie(m_elements_type, m_size, m_size_instanced) = binder.to_vao(m_id).map(std::forward<Arg>(p_args)...);
+                return;
+            }
+            bind();
+            // Bind the attributes for each buffer
+            std::tie(m_elements_type, m_size, m_size_instanced) = binder.map(std::forward<Arg>(p_args)...);
+            // Unbind the vao.
+            unbind();
+        }
+        catch(...)
+        {
+            // The destructor won't run: give the name back and leave no half built vao bound.
+            if(!priv::has_direct_state_access())
+                unbind();
+            release();
+            throw;
+        }
+    }
+
+    void release()
     {
-        // Generate a new vao object and bind it :
-        gl_object_vertexarrays::gl_gen(1, &m_id);
-        bind();
-        // Bind the attributes for each buffer
-        gl_bind_buffers binder(p_program_id);
-        std::tie(m_elements_type, m_size, m_size_instanced) = binder.map(std::forward<Arg>(p_args)...);
-        // Unbind the vao.
-        unbind();
+        if(!m_id)
+            return;
+        if(m_pool)
+        {
+            GLuint bindings = std::count_if(m_bindings.begin(), m_bindings.end(), [](const priv::vao_binding& b)
+            {
+                return b.type != priv::vao_binding::kind::elements;
+            });
+            m_pool->release(m_id, m_enabled, bindings);
+        }
+        else
+            gl_object_vertexarrays::gl_delete(1, &m_id);
+        m_id = 0;
     }
 
     // ================================================================ //
@@ -167,8 +351,45 @@ private:
     std::size_t  m_size;
     /** The size of the instanced arrays. */
     std::size_t  m_size_instanced;
+    /** Mask of the attributes enabled. */
+    std::uint32_t m_enabled;
+    /** The first instance of the instanced buffers, see offset_instances(). */
+    mutable std::size_t m_base_instance;
+    /** The pool the name comes from, or null. */
+    gl_vao_pool*  m_pool;
+    /** The buffers attached, refreshed when bound. */
+    mutable std::vector<priv::vao_binding> m_bindings;
 };
 
+/**
+ * @ingroup attributes
+ * @brief Create a vao independent of any program.
+ *
+ * The attributes are bound to the locations assigned at compile time (see attribute_location),
+ * thus the vao can be drawn with every program whose attribute locations have been bound
+ * with gl_program::bind_attribute_locations() or declared with layout(location = N).
+ * @param p_buffers is the buffers that are gonna be part of this vao.
+ * @return Returns the created vao.
+ */
+template<typename... T>
+gl_vao make_vao(T&&... p_buffers)
+{
+    return gl_vao(nullptr, nullptr, std::forward<T>(p_buffers)...);
+}
+
+/**
+ * @ingroup attributes
+ * @brief Same as make_vao(), with a vao name taken from the passed pool.
+ * @param p_pool is the pool, which must outlive the vao.
+ * @param p_buffers is the buffers that are gonna be part of this vao.
+ * @return Returns the created vao.
+ */
+template<typename... T>
+gl_vao make_vao(gl_vao_pool& p_pool, T&&... p_buffers)
+{
+    return gl_vao(&p_pool, nullptr, std::forward<T>(p_buffers)...);
+}
+
 } /* namespace mgl. */
 
 #endif /* GLVAO_HPP_ */
@@ -0,0 +1,183 @@
+/*
+ * glvaopool.hpp
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: nemikolh
+ */
+
+#ifndef MGL_TYPE_GLVAOPOOL_HPP_
+#define MGL_TYPE_GLVAOPOOL_HPP_
+
+#include <vector>
+#include <cstdint>
+#include <cassert>
+#include "gltraits.hpp"
+
+namespace mgl {
+
+/**
+ * @ingroup attributes
+ * @brief gl_vao_pool recycles the names of the vao released.
+ *
+ * A vao created with make_vao(pool, ...) gives its name back to the pool when
+ * destroyed, instead of deleting it. Its attributes are disabled and its buffers
+ * detached, so that a recycled vao starts from the default state and doesn't keep
+ * any buffer alive. The vao and the array buffer bound by the caller are left bound.
+ *
+ * The pool must outlive the vao created from it.
+ *  @code
+ *      mgl::gl_vao_pool pool;
+ *      ...
+ *      // Every frame:
+ *      mgl::gl_vao vao = mgl::make_vao(pool, geometry, indices);
+ *      mgl::gl_draw(vao);
+ *      ...
+ *      assert(pool.peak() < 16);
+ *  @endcode
+ */
+class gl_vao_pool
+{
+public:
+    // ================================================================ //
+    // =========================== CTOR/DTOR ========================== //
+    // ================================================================ //
+
+    gl_vao_pool()
+        : m_free()
+        , m_live(0)
+        , m_peak(0)
+    {}
+
+    gl_vao_pool(const gl_vao_pool&) = delete;
+    gl_vao_pool& operator=(const gl_vao_pool&) = delete;
+
+    ~gl_vao_pool()
+    {
+#       ifndef MGL_NDEBUG
+        assert(m_live == 0);
+#       endif
+        shrink();
+    }
+
+    // ================================================================ //
+    // ============================ METHODS =========================== //
+    // ================================================================ //
+
+    /**
+     * @brief Returns a vao name, recycled if possible.
+     */
+    gl_types::uid acquire()
+    {
+        gl_types::uid id = 0;
+        // ------------------------- DECLARE ------------------------ //
+
+        if(m_free.empty())
+            gl_object_vertexarrays::gl_gen(1, &id);
+        else
+        {
+            id = m_free.back();
+            m_free.pop_back();
+        }
+        if(++m_live > m_peak)
+            m_peak = m_live;
+        return id;
+    }
+
+    /**
+     * @brief Reset the passed vao and keep its name for a next acquire().
+     * @param p_id is the vao name, returned by acquire().
+     * @param p_enabled is the mask of the enabled attributes.
+     * @param p_bindings is the number of vertex buffer bindings used with direct state access.
+     */
+    void release(gl_types::uid p_id, std::uint32_t p_enabled, GLuint p_bindings)
+    {
+#       ifndef MGL_NDEBUG
+        assert(m_live > 0);
+#       endif
+        if(priv::has_direct_state_access())
+        {
+            for(GLuint location = 0; p_enabled >> location; ++location)
+                if(p_enabled & (1u << location))
+                    gl_object_vertexarrays::gl_disable_attrib(p_id, location);
+            for(GLuint binding = 0; binding < p_bindings; ++binding)
+                gl_object_vertexarrays::gl_bind_vertex_buffer(p_id, binding, 0, 0, 0);
+            gl_object_vertexarrays::gl_element_buffer(p_id, 0);
+        }
+        else
+        {
+            GLint previous_vao = 0;
+            GLint previous_buffer = 0;
+            glCheck(glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &previous_vao));
+            glCheck(glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &previous_buffer));
+
+            gl_object_vertexarrays::gl_bind(p_id);
+            gl_object_buffer<gl_buffer_target<GL_ARRAY_BUFFER>>::gl_bind(0);
+            for(GLuint location = 0; p_enabled >> location; ++location)
+            {
+                if(p_enabled & (1u << location))
+                {
+                    gl_object_vertexarrays::gl_disable_attrib(location);
+                    // Detach the buffer from the attribute.
+                    glCheck(glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, 0, nullptr));
+                    glCheck(glVertexAttribDivisor(location, 0));
+                }
+            }
+            gl_object_buffer<gl_buffer_target<GL_ELEMENT_ARRAY_BUFFER>>::gl_bind(0);
+            // Restore the bindings of the caller, unless it was the released vao.
+            gl_object_vertexarrays::gl_bind(GLuint(previous_vao) == p_id ? 0 : previous_vao);
+            gl_object_buffer<gl_buffer_target<GL_ARRAY_BUFFER>>::gl_bind(previous_buffer);
+        }
+        m_free.push_back(p_id);
+        --m_live;
+    }
+
+    /**
+     * @brief Delete the names waiting in the pool.
+     */
+    void shrink()
+    {
+        if(!m_free.empty())
+            gl_object_vertexarrays::gl_delete(m_free.size(), m_free.data());
+        m_free.clear();
+    }
+
+    /**
+     * @brief Returns the number of vao acquired and not released.
+     */
+    std::size_t live() const
+    {
+        return m_live;
+    }
+
+    /**
+     * @brief Returns the highest number of vao alive at the same time.
+     */
+    std::size_t peak() const
+    {
+        return m_peak;
+    }
+
+    /**
+     * @brief Returns the number of names waiting in the pool.
+     */
+    std::size_t size_free() const
+    {
+        return m_free.size();
+    }
+
+private:
+    // ================================================================ //
+    // ============================= FIELDS =========================== //
+    // ================================================================ //
+
+    /** The released names. */
+    std::vector<gl_types::uid> m_free;
+    /** The number of vao alive. */
+    std::size_t                m_live;
+    /** The highest number of vao alive. */
+    std::size_t                m_peak;
+};
+
+}  /* namespace mgl */
+
+#endif /* MGL_TYPE_GLVAOPOOL_HPP_ */
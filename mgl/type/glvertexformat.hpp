@@ -0,0 +1,284 @@
+/*
+ * glvertexformat.hpp
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: nemikolh
+ */
+
+#ifndef MGL_TYPE_GLVERTEXFORMAT_HPP_
+#define MGL_TYPE_GLVERTEXFORMAT_HPP_
+
+#include <cstdint>
+#include <unordered_map>
+#include <cassert>
+#include "gltraits.hpp"
+#include "../glexceptions.hpp"
+#include "../meta/gllayout.hpp"
+#include "../glvector.hpp"
+
+namespace mgl {
+
+/**
+ * @ingroup attributes
+ * @brief gl_vertex_format is a vao holding only a vertex format, without any buffer.
+ *
+ * It relies on the separate attribute format introduced by ARB_vertex_attrib_binding
+ * (OpenGL 4.3): the format of the attributes is set once, the buffers are bound
+ * at draw time with glBindVertexBuffer. Attributes are bound to their compile-time
+ * locations (see attribute_location).
+ */
+class gl_vertex_format
+{
+public:
+    // ================================================================ //
+    // =========================== CTOR/DTOR ========================== //
+    // ================================================================ //
+
+    gl_vertex_format(gl_vertex_format&& p_rhs)
+        : m_id(p_rhs.m_id)
+        , m_hash(p_rhs.m_hash)
+    {
+        p_rhs.m_id = 0;
+    }
+
+    gl_vertex_format(const gl_vertex_format&) = delete;
+    gl_vertex_format& operator=(const gl_vertex_format&) = delete;
+
+    ~gl_vertex_format()
+    {
+        if(m_id)
+            gl_object_vertexarrays::gl_delete(1, &m_id);
+    }
+
+    // ================================================================ //
+    // ============================ METHODS =========================== //
+    // ================================================================ //
+
+    /**
+     * @brief Returns the hash of the vertex format of T.
+     * Two structures with the same hash share the same gl_vertex_format.
+     */
+    template<typename T>
+    static constexpr std::uint64_t hash_of()
+    {
+        return gl_vertex_layout<T>::format_hash;
+    }
+
+    /**
+     * @brief Create the vao for the vertex format of T.
+     * Without direct state access, the new vao is left bound.
+     */
+    template<typename T>
+    static gl_vertex_format create()
+    {
+        static_assert(priv::is_gl_attributes<T>::value, "T must be declared with MGL_DEFINE_GL_ATTRIBUTES.");
+        gl_vertex_format format(hash_of<T>());
+        GLuint shift = 0;
+        // ------------------------- DECLARE ------------------------ //
+
+        gl_object_vertexarrays::gl_gen(1, &format.m_id);
+        if(!priv::has_direct_state_access())
+            format.bind();
+        for(const gl_attribute_desc& attribute : gl_vertex_layout<T>::attributes)
+            format.setup(priv::bound_attribute(attribute, shift));
+        return format;
+    }
+
+    /**
+     * @brief Bind the vao.
+     */
+    void bind() const
+    {
+        gl_object_vertexarrays::gl_bind(m_id);
+    }
+
+    /**
+     * @brief Bind p_vertices as the source of the attributes. The format must be bound.
+     * @param p_vertices is the vertex buffer.
+     * @param p_first is the index of the first element to read from.
+     */
+    template<typename T, typename B>
+    void bind_vertex_buffer(const gl_vector<T, B>& p_vertices, std::size_t p_first = 0) const
+    {
+#       ifndef MGL_NDEBUG
+        assert(hash_of<T>() == m_hash);
+#       endif
+        gl_object_vertexarrays::gl_bind_vertex_buffer(0, p_vertices.id(), p_first * sizeof(T), sizeof(T));
+    }
+
+    /**
+     * @brief Bind the slice of a gl_frame_allocator as the source of the attributes.
+     * The format must be bound.
+     * @param p_vertices is the slice of vertices.
+     */
+    template<typename T>
+    void bind_vertex_buffer(const gl_frame_slice<T>& p_vertices) const
+    {
+#       ifndef MGL_NDEBUG
+        assert(hash_of<T>() == m_hash);
+#       endif
+        gl_object_vertexarrays::gl_bind_vertex_buffer(0, p_vertices.buffer, p_vertices.offset, sizeof(T));
+    }
+
+    /**
+     * @brief Bind p_indices as the element buffer of the vao. The format must be bound.
+     * @param p_indices is the element buffer.
+     */
+    template<typename I, typename B>
+    void bind_element_buffer(const gl_vector<I, B>& p_indices) const
+    {
+        static_assert(B::target == GL_ELEMENT_ARRAY_BUFFER, "The indices must be stored in an element array buffer.");
+        p_indices.bind();
+    }
+
+    /**
+     * @brief Returns the vao id.
+     */
+    gl_types::uid id() const
+    {
+        return m_id;
+    }
+
+    /**
+     * @brief Returns the hash of the vertex format.
+     */
+    std::uint64_t hash() const
+    {
+        return m_hash;
+    }
+
+private:
+    // ================================================================ //
+    // =========================== CTOR/DTOR ========================== //
+    // ================================================================ //
+
+    explicit gl_vertex_format(std::uint64_t p_hash)
+        : m_id(0)
+        , m_hash(p_hash)
+    {}
+
+    // ================================================================ //
+    // ============================ METHODS =========================== //
+    // ================================================================ //
+
+    // Set the format of the attribute, on the vao with direct state access or on the bound vao otherwise.
+    // A matrix takes one location per column.
+    void setup(const gl_attribute_desc& p_attribute) const
+    {
+        for(GLuint column = 0; column < p_attribute.columns; ++column)
+        {
+            const GLuint location = p_attribute.location + column * (p_attribute.slots / p_attribute.columns);
+            const GLuint offset   = p_attribute.offset + column * (p_attribute.size / p_attribute.columns);
+            if(priv::has_direct_state_access())
+            {
+                gl_object_vertexarrays::gl_enable_attrib(m_id, location);
+                gl_object_vertexarrays::gl_attrib_format(m_id, location, p_attribute.components, p_attribute.gl_type,
+                                                         p_attribute.normalized, offset);
+                gl_object_vertexarrays::gl_attrib_binding(m_id, location, 0);
+                continue;
+            }
+            gl_object_vertexarrays::gl_enable_attrib(location);
+            gl_object_vertexarrays::gl_attrib_format(location, p_attribute.components, p_attribute.gl_type,
+                                                     p_attribute.normalized, offset);
+            gl_object_vertexarrays::gl_attrib_binding(location, 0);
+        }
+    }
+
+    // ================================================================ //
+    // ============================= FIELDS =========================== //
+    // ================================================================ //
+
+    /** The vao id. */
+    gl_types::uid m_id;
+    /** Hash of the vertex format. */
+    std::uint64_t m_hash;
+};
+
+/**
+ * @ingroup attributes
+ * @brief gl_vertex_format_cache creates one gl_vertex_format per distinct vertex format.
+ *
+ * Instead of one vao per (mesh, program), meshes sharing a vertex format share one vao.
+ * Switching from a mesh to another is then a glBindVertexBuffer plus an element buffer bind:
+ *  @code
+ *      mgl::gl_vertex_format_cache formats;
+ *      ...
+ *      program.use();
+ *      for(auto& mesh : meshes)
+ *      {
+ *          formats.bind(mesh.vertices, mesh.indices);
+ *          mgl::gl_draw(mesh.vertices, mesh.indices);
+ *      }
+ *  @endcode
+ * The programs must use the compile-time locations, see gl_program::bind_attribute_locations().
+ */
+class gl_vertex_format_cache
+{
+public:
+    // ================================================================ //
+    // =========================== CTOR/DTOR ========================== //
+    // ================================================================ //
+
+    gl_vertex_format_cache()
+        : m_formats()
+    {}
+
+    gl_vertex_format_cache(const gl_vertex_format_cache&) = delete;
+    gl_vertex_format_cache& operator=(const gl_vertex_format_cache&) = delete;
+
+    // ================================================================ //
+    // ============================ METHODS =========================== //
+    // ================================================================ //
+
+    /**
+     * @brief Returns the vertex format of T, creating it the first time.
+     */
+    template<typename T>
+    const gl_vertex_format& format()
+    {
+        std::uint64_t hash = gl_vertex_format::hash_of<T>();
+        auto it = m_formats.find(hash);
+        if(it == m_formats.end())
+            it = m_formats.emplace(hash, gl_vertex_format::create<T>()).first;
+        return it->second;
+    }
+
+    /**
+     * @brief Bind the vertex format of T and the passed buffers.
+     * The redundant binds of the vao are filtered by the gl_state_cache.
+     * @param p_vertices is the vertex buffer.
+     * @param p_indices is the element buffer.
+     * @return Returns the bound vertex format.
+     */
+    template<typename T, typename B, typename I, typename BI>
+    const gl_vertex_format& bind(const gl_vector<T, B>& p_vertices, const gl_vector<I, BI>& p_indices)
+    {
+        const gl_vertex_format& f = format<T>();
+        // ------------------------- DECLARE ------------------------ //
+
+        f.bind();
+        f.bind_vertex_buffer(p_vertices);
+        f.bind_element_buffer(p_indices);
+        return f;
+    }
+
+    /**
+     * @brief Returns the number of vertex formats created.
+     */
+    std::size_t size() const
+    {
+        return m_formats.size();
+    }
+
+private:
+    // ================================================================ //
+    // ============================= FIELDS =========================== //
+    // ================================================================ //
+
+    /** The vertex formats by hash. */
+    std::unordered_map<std::uint64_t, gl_vertex_format> m_formats;
+};
+
+}  /* namespace mgl */
+
+#endif /* MGL_TYPE_GLVERTEXFORMAT_HPP_ */
@@ -0,0 +1,146 @@
+#ifndef CHUNKEDVECTORPROPERUSE_H_
+#define CHUNKEDVECTORPROPERUSE_H_
+
+#include <cxxtest/TestSuite.h>
+#include <SFML/Graphics.hpp>
+
+#include "../mgl/glrequires.hpp"
+#include "../mgl/gldata.hpp"
+#include "../mgl/gldraw.hpp"
+#include "../mgl/glchunkedvector.hpp"
+
+MGL_DEFINE_GL_ATTRIBUTES((chunked_test), point, (glm::vec2, position))
+
+using namespace mgl;
+
+class ChunkedVectorProperUse : public CxxTest::TestSuite
+{
+    std::unique_ptr<sf::Window> window;
+public:
+    void setUp()
+    {
+        sf::ContextSettings settings;
+        settings.majorVersion = 4;
+        settings.minorVersion = 3;
+
+        window.reset(new sf::Window(sf::VideoMode(800, 600), "OpenGL", sf::Style::Default, settings));
+        window->setVisible(false);
+
+        GLenum err = glewInit();
+        if (GLEW_OK != err)
+        {
+            std::cerr << "GLEW error: " << glewGetErrorString(err) << std::endl;
+        }
+    }
+
+    void tearDown()
+    {
+        window->close();
+        window.reset();
+    }
+
+    void testAppendNeverMoves()
+    {
+        gl_chunked_vector<float> values(4);
+        {
+            auto lock = bind_at_scope(values);
+            for(int i = 0; i < 10; ++i)
+                values.push_back(float(i));
+        }
+        TS_ASSERT_EQUALS(values.size(), 10u);
+        TS_ASSERT_EQUALS(values.chunk_count(), 3u);
+        GLuint first = values.chunk(0).id();
+
+        auto lock = bind_at_scope(values);
+        for(int i = 10; i < 100; ++i)
+            values.push_back(float(i));
+        TS_ASSERT_EQUALS(values.chunk(0).id(), first);
+        TS_ASSERT_EQUALS(values[3], 3.f);
+        TS_ASSERT_EQUALS(values[99], 99.f);
+    }
+
+    void testEraseSwapsLast()
+    {
+        gl_chunked_vector<float> values(4);
+        auto lock = bind_at_scope(values);
+        for(int i = 0; i < 5; ++i)
+            values.push_back(float(i));
+
+        values.erase(1);
+        TS_ASSERT_EQUALS(values.size(), 4u);
+        TS_ASSERT_EQUALS(values[1], 4.f);
+        values.erase(3);
+        TS_ASSERT_EQUALS(values.size(), 3u);
+        TS_ASSERT_EQUALS(values.back(), 2.f);
+
+        // The empty chunk is kept for the next appends.
+        TS_ASSERT_EQUALS(values.chunk_count(), 2u);
+        values.shrink_to_fit();
+        TS_ASSERT_EQUALS(values.chunk_count(), 1u);
+    }
+
+    void testPushAfterPop()
+    {
+        gl_chunked_vector<float> values(4);
+        auto lock = bind_at_scope(values);
+        for(int i = 0; i < 9; ++i)
+            values.push_back(float(i));
+        for(int i = 0; i < 5; ++i)
+            values.pop_back();
+
+        // The append fills the first chunk again, not the last empty one.
+        values.push_back(42.f);
+        TS_ASSERT_EQUALS(values.size(), 5u);
+        TS_ASSERT_EQUALS(values.chunk_count(), 3u);
+        TS_ASSERT_EQUALS(values[4], 42.f);
+        TS_ASSERT_EQUALS(values.chunk(1).size(), 1u);
+        TS_ASSERT_EQUALS(values.chunk(2).size(), 0u);
+    }
+
+    void testPopMapsOnce()
+    {
+        gl_chunked_vector<float> values(4);
+        {
+            auto lock = bind_at_scope(values);
+            for(int i = 0; i < 9; ++i)
+                values.push_back(float(i));
+        }
+        TS_ASSERT(!values.chunk(1).is_mapped());
+
+        {
+            // The chunk stays mapped from the first pop_back to the end of the scope.
+            auto lock = bind_at_scope(values);
+            for(int i = 0; i < 3; ++i)
+                values.pop_back();
+            TS_ASSERT(values.chunk(1).is_mapped());
+            TS_ASSERT_EQUALS(values.back(), 5.f);
+        }
+        TS_ASSERT(!values.chunk(1).is_mapped());
+
+        values.clear();
+        TS_ASSERT(values.empty());
+        TS_ASSERT_EQUALS(values.chunk(0).size(), 0u);
+        TS_ASSERT(!values.chunk(0).is_mapped());
+    }
+
+    void testDrawChunks()
+    {
+        if(!GLEW_VERSION_4_3 && !GLEW_ARB_vertex_attrib_binding)
+        {
+            TS_WARN("The separate attribute format isn't supported, the test is skipped.");
+            return;
+        }
+
+        gl_chunked_vector<chunked_test::point> points(3);
+        {
+            auto lock = bind_at_scope(points);
+            for(int i = 0; i < 7; ++i)
+                points.push_back({ glm::vec2(0.f, 0.f) });
+        }
+        gl_vertex_format format = gl_vertex_format::create<chunked_test::point>();
+        TS_ASSERT_THROWS_NOTHING(gl_draw(format, points, GL_POINTS));
+        TS_ASSERT_THROWS_NOTHING(mgl::priv::glTryError());
+    }
+};
+
+#endif /* CHUNKEDVECTORPROPERUSE_H_ */
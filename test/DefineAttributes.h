@@ -5,9 +5,27 @@
 #include <cxxtest/TestSuite.h>
 #include "../mgl/glrequires.hpp"
 #include <SFML/Graphics.hpp>
+#include <glm/glm.hpp>
 #include "../mgl/gldata.hpp"
+#include "../mgl/meta/gllayout.hpp"
+#include "../mgl/meta/glpacking.hpp"
 
 MGL_DEFINE_GL_ATTRIBUTES((tmp), test, (char, pos)(double, length))
+MGL_DEFINE_GL_ATTRIBUTES((tmp), precise, (glm::dvec3, origin)(glm::vec2, uv))
+MGL_DEFINE_GL_ATTRIBUTES((tmp), bytes, (char, first)(char, second)(float, weight))
+MGL_DEFINE_GL_ATTRIBUTES((tmp), spread, (char, first)(float, weight)(char, second))
+MGL_DEFINE_GL_ATTRIBUTES((tmp), transform, (glm::mat4, model)(glm::vec4, color)(glm::mat3, normal)(float, scale))
+
+namespace tmp {
+struct particle
+{
+    glm::vec3   position;
+    glm::vec3   velocity;
+    float       mass;
+};
+}
+
+MGL_ADAPT_TO_GL_ATTRIBUTES_CHECKED_SIZE(tmp::particle, 28, (glm::vec3, position)(float, mass))
 
 class DefineAttributes : public CxxTest::TestSuite
 {
@@ -49,6 +67,98 @@ public:
         offset = mgl::offset_at<tmp::test, 1>::value;
         TS_ASSERT_EQUALS(offset, sizeof(double));
     }
+
+    void testMatrixLocations()
+    {
+        // A matrix takes one location per column.
+        unsigned int location = mgl::attribute_location<tmp::transform, 0>::value;
+        TS_ASSERT_EQUALS(location, 0u);
+
+        location = mgl::attribute_location<tmp::transform, 1>::value;
+        TS_ASSERT_EQUALS(location, 4u);
+
+        location = mgl::attribute_location<tmp::transform, 2>::value;
+        TS_ASSERT_EQUALS(location, 5u);
+
+        location = mgl::attribute_location<tmp::transform, 3>::value;
+        TS_ASSERT_EQUALS(location, 8u);
+    }
+
+    void testLayoutTable()
+    {
+        typedef mgl::gl_vertex_layout<tmp::transform> layout;
+        static_assert(layout::size == 4, "The table has one entry per member.");
+        static_assert(layout::attributes[2].location == 5 && layout::attributes[2].columns == 3, "");
+
+        std::size_t size = layout::size;
+        TS_ASSERT_EQUALS(size, 4u);
+        std::string name = layout::attributes[1].name;
+        TS_ASSERT_EQUALS(name, "color");
+        std::size_t offset = layout::attributes[3].offset;
+        TS_ASSERT_EQUALS(offset, sizeof(glm::mat4) + sizeof(glm::vec4) + sizeof(glm::mat3));
+        GLenum type = layout::attributes[0].gl_type;
+        TS_ASSERT_EQUALS(type, static_cast<GLenum>(GL_FLOAT));
+
+        // The hashes are computed at compile time.
+        static_assert(layout::hash != layout::format_hash, "");
+    }
+
+    void testDoubleLocations()
+    {
+        typedef mgl::gl_vertex_layout<tmp::precise> layout;
+        static_assert(layout::attributes[1].location == 2, "A dvec3 takes two locations at compile time.");
+
+        // Converted to float, the dvec3 takes a single location.
+        GLuint expected = mgl::priv::has_vertex_attrib_64bit() ? 2 : 1;
+        TS_ASSERT_EQUALS(layout::location(0), 0u);
+        TS_ASSERT_EQUALS(layout::location(1), expected);
+    }
+
+    void testAdaptedStructure()
+    {
+        typedef mgl::gl_vertex_layout<tmp::particle> layout;
+        static_assert(layout::size == 2, "Only the adapted members are attributes.");
+
+        std::size_t offset = layout::attributes[1].offset;
+        TS_ASSERT_EQUALS(offset, offsetof(tmp::particle, mass));
+        unsigned int location = mgl::attribute_location<tmp::particle, 1>::value;
+        TS_ASSERT_EQUALS(location, 1u);
+        std::size_t stride = layout::stride;
+        TS_ASSERT_EQUALS(stride, sizeof(tmp::particle));
+    }
+
+    void testLayoutPlan()
+    {
+        // 9 bytes of data in 16 bytes, the double can't be moved to save anything.
+        typedef mgl::gl_layout_plan<tmp::test> plan;
+        std::size_t wasted = plan::wasted_bytes;
+        TS_ASSERT_EQUALS(wasted, 7u);
+        std::size_t saved = plan::saved_bytes;
+        TS_ASSERT_EQUALS(saved, 0u);
+        unsigned int first = plan::order[0];
+        TS_ASSERT_EQUALS(first, 1u);
+        TS_ASSERT(plan::is_packed);
+
+        TS_ASSERT(mgl::gl_layout_plan<tmp::transform>::is_packed);
+
+        // No order starts both chars on a 4 bytes boundary in 8 bytes, the declared one is the best.
+        typedef mgl::gl_layout_plan<tmp::bytes> bytes_plan;
+        static_assert(bytes_plan::is_packed, "");
+        saved = bytes_plan::saved_bytes;
+        TS_ASSERT_EQUALS(saved, 0u);
+        std::size_t misaligned = bytes_plan::misaligned;
+        TS_ASSERT_EQUALS(misaligned, 1u);
+
+        // Moving the float first removes the padding around it.
+        typedef mgl::gl_layout_plan<tmp::spread> spread_plan;
+        static_assert(!spread_plan::is_packed, "");
+        saved = spread_plan::saved_bytes;
+        TS_ASSERT_EQUALS(saved, 4u);
+        std::size_t stride = spread_plan::packed_stride;
+        TS_ASSERT_EQUALS(stride, sizeof(tmp::bytes));
+        first = spread_plan::order[0];
+        TS_ASSERT_EQUALS(first, 1u);
+    }
 };
 
 #endif /*DEFINEATTRIBUTES_H_*/
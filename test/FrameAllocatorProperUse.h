@@ -0,0 +1,120 @@
+#ifndef FRAMEALLOCATORPROPERUSE_H_
+#define FRAMEALLOCATORPROPERUSE_H_
+
+#include <cxxtest/TestSuite.h>
+#include <SFML/Graphics.hpp>
+
+#include "../mgl/glrequires.hpp"
+#include "../mgl/gldata.hpp"
+#include "../mgl/gldraw.hpp"
+#include "../mgl/memory/glframeallocator.hpp"
+
+MGL_DEFINE_GL_ATTRIBUTES((frame_test), vertex, (glm::vec3, position))
+
+using namespace mgl;
+
+class FrameAllocatorProperUse : public CxxTest::TestSuite
+{
+    std::unique_ptr<sf::Window> window;
+public:
+    void setUp()
+    {
+        sf::ContextSettings settings;
+        settings.majorVersion = 4;
+        settings.minorVersion = 3;
+
+        window.reset(new sf::Window(sf::VideoMode(800, 600), "OpenGL", sf::Style::Default, settings));
+        window->setVisible(false);
+
+        GLenum err = glewInit();
+        if (GLEW_OK != err)
+        {
+            std::cerr << "GLEW error: " << glewGetErrorString(err) << std::endl;
+        }
+    }
+
+    void tearDown()
+    {
+        window->close();
+        window.reset();
+    }
+
+    void testAlignedSlices()
+    {
+        GLint uniform_alignment = 0;
+        glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &uniform_alignment);
+        gl_frame_allocator frame(4096, 2);
+
+        frame.begin_frame();
+        auto indices  = frame.allocate<std::uint8_t>(3, gl_frame_use::index);
+        auto vertices = frame.allocate<frame_test::vertex>(3);
+        auto block    = frame.allocate<glm::vec4>(2, gl_frame_use::uniform);
+        TS_ASSERT_EQUALS(vertices.offset % 12, 0);
+        TS_ASSERT_EQUALS(vertices.first() * sizeof(frame_test::vertex), std::size_t(vertices.offset));
+        TS_ASSERT_EQUALS(block.offset % uniform_alignment, 0);
+        TS_ASSERT(block.offset >= vertices.offset + GLintptr(3 * sizeof(frame_test::vertex)));
+        TS_ASSERT_THROWS(frame.allocate<char>(4096), const gl_out_of_memory&);
+        frame.end_frame();
+
+        // The next frame uses the next region, then the first one again once the GPU is done.
+        frame.begin_frame();
+        TS_ASSERT_EQUALS(frame.allocate<float>(1).offset, 4096);
+        frame.end_frame();
+        frame.begin_frame();
+        TS_ASSERT_EQUALS(frame.allocate<float>(1).offset, 0);
+        frame.end_frame();
+        TS_ASSERT_THROWS_NOTHING(mgl::priv::glTryError());
+    }
+
+    void testEmptyAllocation()
+    {
+        gl_frame_allocator frame(64, 2);
+
+        frame.begin_frame();
+        frame.allocate<char>(64);
+        // The region is full, and unmapped without persistent mapping: nothing to point to.
+        frame.flush();
+        gl_frame_slice<float> empty = frame.allocate<float>(0);
+        TS_ASSERT(empty.pointer == nullptr);
+        TS_ASSERT_EQUALS(empty.size(), 0u);
+        TS_ASSERT(empty.begin() == empty.end());
+        TS_ASSERT_EQUALS(frame.used(), 64u);
+        frame.end_frame();
+        TS_ASSERT_THROWS_NOTHING(mgl::priv::glTryError());
+    }
+
+    void testDrawFromFrame()
+    {
+        gl_frame_allocator frame(1 << 16);
+        std::vector<frame_test::vertex> triangle(3, { glm::vec3(0.f, 0.f, 0.f) });
+        gl_vao vao = make_vao(frame.view<frame_test::vertex>(), frame.view<std::uint16_t>());
+        std::unique_ptr<gl_vertex_format> format;
+        if(GLEW_VERSION_4_3 || GLEW_ARB_vertex_attrib_binding)
+            format.reset(new gl_vertex_format(gl_vertex_format::create<frame_test::vertex>()));
+
+        for(int f = 0; f < 5; ++f)
+        {
+            frame.begin_frame();
+            triangle[0].position.x = float(f);
+            auto vertices = frame.push(triangle.data(), triangle.size());
+            auto indices  = frame.allocate<std::uint16_t>(3, gl_frame_use::index);
+            for(std::uint16_t i = 0; i < 3; ++i)
+                indices[i] = i;
+            frame.flush();
+
+            glm::vec3 written;
+            gl_object_buffer<gl_buffer_type<float>>::gl_bind(frame.id());
+            glGetBufferSubData(GL_ARRAY_BUFFER, vertices.offset, sizeof(written), &written);
+            TS_ASSERT_EQUALS(written.x, float(f));
+
+            TS_ASSERT_THROWS_NOTHING(gl_draw(vao, gl_draw_range(GL_TRIANGLES, indices.first(), 3)
+                                                      .with_base_vertex(vertices.first())));
+            if(format)
+                TS_ASSERT_THROWS_NOTHING(gl_draw(*format, vertices, indices));
+            frame.end_frame();
+        }
+        TS_ASSERT_THROWS_NOTHING(mgl::priv::glTryError());
+    }
+};
+
+#endif /* FRAMEALLOCATORPROPERUSE_H_ */
@@ -0,0 +1,184 @@
+#ifndef FRUSTUMCULLINGPROPERUSE_H_
+#define FRUSTUMCULLINGPROPERUSE_H_
+
+#include <cxxtest/TestSuite.h>
+#include <SFML/Graphics.hpp>
+
+#include <cmath>
+#include <random>
+#include "../mgl/glrequires.hpp"
+#include "../mgl/gldata.hpp"
+#include "../mgl/glscope.hpp"
+#include "../mgl/extension/frustum_culling.hpp"
+
+using namespace mgl::extension;
+
+MGL_DEFINE_GL_ATTRIBUTES((cull_test), instance, (glm::vec4, color)(glm::vec3, position))
+
+class FrustumCullingProperUse : public CxxTest::TestSuite
+{
+    std::unique_ptr<sf::Window> window;
+
+    /*
+     * The smallest distance of the box to the planes, summed as the AVX2 path does.
+     */
+    static float min_distance(const frustum& p_frustum, const glm::vec3& p_center, const glm::vec3& p_extent)
+    {
+        float result = INFINITY;
+        for(const glm::vec4& plane : p_frustum.planes)
+        {
+            float d = plane.w + plane.x * p_center.x + plane.y * p_center.y + plane.z * p_center.z
+                    + std::fabs(plane.x) * p_extent.x + std::fabs(plane.y) * p_extent.y
+                    + std::fabs(plane.z) * p_extent.z;
+            result = std::min(result, d);
+        }
+        return result;
+    }
+
+public:
+    void setUp()
+    {
+        sf::ContextSettings settings;
+        settings.majorVersion = 3;
+        settings.minorVersion = 3;
+
+        window.reset(new sf::Window(sf::VideoMode(800, 600), "OpenGL", sf::Style::Default, settings));
+        window->setVisible(false);
+
+        GLenum err = glewInit();
+        if (GLEW_OK != err)
+        {
+            std::cerr << "GLEW error: " << glewGetErrorString(err) << std::endl;
+        }
+    }
+
+    void tearDown()
+    {
+        window->close();
+        window.reset();
+    }
+
+    void testMatchesScalarTest()
+    {
+        // The identity matrix gives the cube [-1, 1]^3.
+        frustum f = frustum::from_matrix(glm::mat4(1.f));
+        std::mt19937 random(42);
+        std::uniform_real_distribution<float> position(-3.f, 3.f), radius(0.f, 1.f);
+        std::vector<glm::vec3> centers, extents;
+        instance_bounds bounds;
+        while(centers.size() < 100003)
+        {
+            glm::vec3 center(position(random), position(random), position(random));
+            glm::vec3 extent(radius(random));
+            // The boxes touching a plane depend on the rounding, thus on the path.
+            if(std::fabs(min_distance(f, center, extent)) < 1e-3f)
+                continue;
+            centers.push_back(center);
+            extents.push_back(extent);
+            bounds.push_box(center - extent, center + extent);
+        }
+        std::vector<std::uint32_t> visible(bounds.size());
+        frustum_culler culler(4);
+
+        // The second call reuses the threads of the first one.
+        for(int run = 0; run < 2; ++run)
+        {
+            std::size_t count = culler.cull(f, bounds, visible.data());
+
+            std::size_t j = 0;
+            for(std::size_t i = 0; i < centers.size(); ++i)
+            {
+                // The mirror of the AVX2 predicate, which culls when !(d >= 0).
+                if(min_distance(f, centers[i], extents[i]) >= 0.f)
+                {
+                    TS_ASSERT(j < count);
+                    TS_ASSERT_EQUALS(visible[j++], i);
+                }
+            }
+            TS_ASSERT_EQUALS(j, count);
+        }
+    }
+
+    void testCommandsMergeRuns()
+    {
+        frustum f = frustum::from_matrix(glm::mat4(1.f));
+        instance_bounds bounds;
+        for(float x : { 0.f, 0.5f, 5.f, 0.f, 0.f, 0.f, 7.f, 0.f })
+            bounds.push_sphere(glm::vec3(x, 0.f, 0.f), 0.1f);
+        mgl::draw_elements_indirect_command mesh{ 36, 0, 6, 2, 0 };
+        std::vector<mgl::draw_elements_indirect_command> commands(bounds.size());
+
+        std::size_t count = frustum_culler(1).cull(f, bounds, commands.data(), mesh);
+
+        TS_ASSERT_EQUALS(count, 3u);
+        TS_ASSERT_EQUALS(commands[0].base_instance, 0u);
+        TS_ASSERT_EQUALS(commands[0].instance_count, 2u);
+        TS_ASSERT_EQUALS(commands[1].base_instance, 3u);
+        TS_ASSERT_EQUALS(commands[1].instance_count, 3u);
+        TS_ASSERT_EQUALS(commands[2].base_instance, 7u);
+        TS_ASSERT_EQUALS(commands[2].instance_count, 1u);
+        TS_ASSERT_EQUALS(commands[2].count, 36u);
+        TS_ASSERT_EQUALS(commands[2].first_index, 6u);
+        TS_ASSERT_EQUALS(commands[2].base_vertex, 2);
+    }
+
+    void testAssignAttribute()
+    {
+        mgl::gl_vector<cull_test::instance> instances = {
+            { glm::vec4(1.f, 1.f, 1.f, 1.f), glm::vec3(0.f, 0.f, 0.f) },
+            { glm::vec4(1.f, 1.f, 1.f, 1.f), glm::vec3(5.f, 0.f, 0.f) },
+            { glm::vec4(1.f, 1.f, 1.f, 1.f), glm::vec3(0.5f, -0.5f, 0.f) },
+        };
+        instance_bounds by_index, by_name;
+
+        by_index.assign<1>(instances, glm::vec3(0.1f));
+        by_name.assign(instances, "position", glm::vec3(0.1f));
+
+        TS_ASSERT_EQUALS(by_index.size(), 3u);
+        TS_ASSERT_EQUALS(by_name.size(), 3u);
+        for(std::size_t i = 0; i < 3; ++i)
+        {
+            TS_ASSERT_EQUALS(by_index.boxes().cx[i], by_name.boxes().cx[i]);
+            TS_ASSERT_EQUALS(by_index.boxes().cy[i], by_name.boxes().cy[i]);
+            TS_ASSERT_EQUALS(by_index.boxes().ez[i], 0.1f);
+        }
+        TS_ASSERT_EQUALS(by_name.boxes().cx[1], 5.f);
+        TS_ASSERT_EQUALS(by_name.boxes().cy[2], -0.5f);
+        TS_ASSERT(!instances.is_mapped());
+
+        // color isn't a glm::vec3.
+        TS_ASSERT_THROWS(by_name.assign(instances, "color", glm::vec3(0.1f)), mgl::gl_exception_specific);
+        TS_ASSERT_THROWS(by_name.assign(instances, "velocity", glm::vec3(0.1f)), mgl::gl_exception_specific);
+    }
+
+    void testCullIntoVectors()
+    {
+        frustum f = frustum::from_matrix(glm::mat4(1.f));
+        instance_bounds bounds;
+        for(float x : { 0.f, 5.f, 0.5f, 0.f, -7.f })
+            bounds.push_sphere(glm::vec3(x, 0.f, 0.f), 0.1f);
+        mgl::gl_vector<std::uint32_t> visible;
+        mgl::gl_vector<mgl::draw_elements_indirect_command> commands;
+        mgl::draw_elements_indirect_command mesh{ 36, 0, 0, 0, 0 };
+        frustum_culler culler(2);
+
+        TS_ASSERT_EQUALS(culler.cull(f, bounds, visible), 3u);
+        TS_ASSERT_EQUALS(culler.cull(f, bounds, commands, mesh), 2u);
+
+        TS_ASSERT_EQUALS(visible.size(), 3u);
+        TS_ASSERT_EQUALS(commands.size(), 2u);
+        TS_ASSERT(!visible.is_mapped());
+        auto lock_visible  = mgl::bind_at_scope(visible);
+        auto lock_commands = mgl::bind_at_scope(commands);
+        TS_ASSERT_EQUALS(visible[0], 0u);
+        TS_ASSERT_EQUALS(visible[1], 2u);
+        TS_ASSERT_EQUALS(visible[2], 3u);
+        TS_ASSERT_EQUALS(commands[0].base_instance, 0u);
+        TS_ASSERT_EQUALS(commands[0].instance_count, 1u);
+        TS_ASSERT_EQUALS(commands[1].base_instance, 2u);
+        TS_ASSERT_EQUALS(commands[1].instance_count, 2u);
+        TS_ASSERT_EQUALS(commands[1].count, 36u);
+    }
+};
+
+#endif /* FRUSTUMCULLINGPROPERUSE_H_ */
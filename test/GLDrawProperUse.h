@@ -0,0 +1,296 @@
+#ifndef GLDRAWPROPERUSE_H_
+#define GLDRAWPROPERUSE_H_
+
+#include <cxxtest/TestSuite.h>
+
+#include "OffscreenTarget.h"
+#include "../mgl/gldata.hpp"
+#include "../mgl/gldraw.hpp"
+#include "../mgl/meta/glinstanced.hpp"
+
+MGL_DEFINE_GL_ATTRIBUTES((draw_test), vertex, (glm::vec3, position))
+MGL_DEFINE_GL_ATTRIBUTES((draw_test), instance, (glm::vec3, offset))
+MGL_DEFINE_GL_ATTRIBUTES((draw_test), tagged, (glm::vec3, position)(std::uint32_t, id)(std::int32_t, delta))
+
+namespace draw_test {
+/*
+ * Commands stored like the output of the GPU culling.
+ */
+struct storage_commands
+{
+    static constexpr GLenum target = GL_SHADER_STORAGE_BUFFER;
+    static constexpr GLenum usage  = GL_DYNAMIC_COPY;
+};
+}
+
+namespace mgl {
+template<>
+struct attribute_location_base<draw_test::instance>
+{
+    static constexpr unsigned int value = 1;
+};
+}
+
+using namespace mgl;
+
+/*
+ * The draws are made in a 8x8 framebuffer: the instance i of the quad covers the pixel (i, i)
+ * and turns it green, its red channel tells which instance data has been read.
+ * Build with MGL_NO_BASE_INSTANCE or MGL_NO_MULTI_DRAW_INDIRECT to run the fallbacks.
+ */
+class GLDrawProperUse : public CxxTest::TestSuite
+{
+    std::unique_ptr<offscreen_target> target;
+public:
+    void setUp()
+    {
+        target.reset(new offscreen_target(4, 3));
+    }
+
+    void tearDown()
+    {
+        target.reset();
+    }
+
+    /*
+     * Returns the red channel of the pixel (x, x) of the last draws.
+     */
+    int red(int x) const
+    {
+        return target->pixel(x, x)[0];
+    }
+
+    /*
+     * Returns true if the pixel (x, x) has been drawn.
+     */
+    bool drawn(int x) const
+    {
+        return target->pixel(x, x)[1] == 255;
+    }
+
+    void read()
+    {
+        target->read();
+    }
+
+    /*
+     * Returns a program drawing the quad at offset, with a red channel of shade.
+     */
+    gl_program make_program()
+    {
+        return make_test_program("#version 330\n"
+                                 "layout(location = 0) in vec3 position;\n"
+                                 "layout(location = 1) in vec3 offset;\n"
+                                 "layout(location = 2) in float shade;\n"
+                                 "out float red;\n"
+                                 "void main(void){ gl_Position = vec4(position + offset, 1.0); red = shade; }",
+                                 "#version 330\n"
+                                 "in float red;\n"
+                                 "out vec4 color;\n"
+                                 "void main(void){ color = vec4(red, 1.0, 0.0, 1.0); }");
+    }
+
+    /*
+     * Returns true if exactly the pixels (x, x) with x in [p_first, p_last[ have been drawn.
+     */
+    bool drawn_between(int p_first, int p_last) const
+    {
+        for(int x = 0; x < 8; ++x)
+        {
+            if(drawn(x) != (x >= p_first && x < p_last))
+                return false;
+        }
+        return true;
+    }
+
+    void testDrawRange()
+    {
+        gl_program program = make_program();
+        std::vector<draw_test::vertex> diagonal;
+        for(int x = 0; x < 8; ++x)
+            diagonal.push_back(draw_test::vertex{ glm::vec3(-0.875f + x * 0.25f, -0.875f + x * 0.25f, 0.f) });
+        gl_vector<draw_test::vertex> points(diagonal.begin(), diagonal.end());
+        gl_vector<std::uint32_t> indices = { 0, 1, 2, 3 };
+        gl_vector<draw_test::instance> offsets = {
+            { glm::vec3(0.f) }, { glm::vec3(0.25f, 0.25f, 0.f) }, { glm::vec3(0.5f, 0.5f, 0.f) }, { glm::vec3(0.75f, 0.75f, 0.f) }
+        };
+        gl_vao arrays   = make_vao(points);
+        gl_vao elements = make_vao(points, indices);
+        gl_vao instanced = make_vao(points, make_instanced(offsets));
+        // ------------------------- DECLARE ------------------------ //
+
+        program.use();
+        TS_TRACE("glDrawArrays, from the first vertex then up to the end");
+        glClear(GL_COLOR_BUFFER_BIT);
+        gl_draw(arrays, gl_draw_range(GL_POINTS, 2, 3));
+        read();
+        TS_ASSERT(drawn_between(2, 5));
+        glClear(GL_COLOR_BUFFER_BIT);
+        gl_draw(arrays, gl_draw_range(GL_POINTS, 6));
+        read();
+        TS_ASSERT(drawn_between(6, 8));
+
+        TS_TRACE("glDrawElements, then glDrawElementsBaseVertex");
+        glClear(GL_COLOR_BUFFER_BIT);
+        gl_draw(elements, gl_draw_range(GL_POINTS, 1, 2));
+        read();
+        TS_ASSERT(drawn_between(1, 3));
+        glClear(GL_COLOR_BUFFER_BIT);
+        gl_draw(elements, gl_draw_range(GL_POINTS).with_base_vertex(4));
+        read();
+        TS_ASSERT(drawn_between(4, 8));
+
+        TS_TRACE("glDrawArraysInstanced, then with a base instance");
+        glClear(GL_COLOR_BUFFER_BIT);
+        gl_draw(instanced, gl_draw_range(GL_POINTS, 0, 1).with_instances(3));
+        read();
+        TS_ASSERT(drawn_between(0, 3));
+        glClear(GL_COLOR_BUFFER_BIT);
+        gl_draw(instanced, gl_draw_range(GL_POINTS, 4, 1).with_instances(2, 2));
+        read();
+        TS_ASSERT(drawn_between(6, 8));
+
+        TS_TRACE("glDrawElementsInstancedBaseVertex");
+        glClear(GL_COLOR_BUFFER_BIT);
+        gl_vao both = make_vao(points, indices, make_instanced(offsets));
+        gl_draw(both, gl_draw_range(GL_POINTS, 0, 2).with_base_vertex(2).with_instances(2));
+        read();
+        TS_ASSERT(drawn_between(2, 5));
+        TS_ASSERT_THROWS_NOTHING(priv::glTryError());
+    }
+
+    void testDivisorAndBaseInstance()
+    {
+        gl_program program = make_program();
+        gl_vector<draw_test::vertex> quad = {
+            { glm::vec3(-1.f, -1.f, 0.f) }, { glm::vec3(-0.75f, -1.f, 0.f) },
+            { glm::vec3(-0.75f, -0.75f, 0.f) }, { glm::vec3(-1.f, -0.75f, 0.f) }
+        };
+        gl_vector<std::uint32_t> indices = { 0, 1, 2, 0, 2, 3 };
+        std::vector<draw_test::instance> diagonal;
+        for(int x = 0; x < 8; ++x)
+            diagonal.push_back(draw_test::instance{ glm::vec3(x * 0.25f, x * 0.25f, 0.f) });
+        gl_vector<draw_test::instance> offsets(diagonal.begin(), diagonal.end());
+        // One shade per two instances.
+        gl_vector<float> shades = { 1.f, 0.f, 0.f, 0.f, 1.f, 0.f };
+        gl_vao vao = make_vao(quad, indices, make_instanced(offsets), make_instanced(make_buffer(shades, "shade", 2), 2));
+        // ------------------------- DECLARE ------------------------ //
+
+        TS_TRACE("A buffer must hold base + ceil(count / divisor) elements");
+        TS_ASSERT(vao.covers_instances(4, 4));
+        TS_ASSERT(vao.covers_instances(2, 5));
+        TS_ASSERT(!vao.covers_instances(3, 5));
+        TS_ASSERT(!vao.covers_instances(4, 5));
+        TS_ASSERT(!vao.covers_instances(13, 0));
+
+        TS_TRACE("The base instance is added after the division by the divisor");
+        program.use();
+        glClear(GL_COLOR_BUFFER_BIT);
+        gl_draw_instanced(vao, 4, 4);
+        read();
+        TS_ASSERT(drawn_between(4, 8));
+        TS_ASSERT_EQUALS(red(4), 255);
+        TS_ASSERT_EQUALS(red(5), 255);
+        TS_ASSERT_EQUALS(red(6), 0);
+        TS_ASSERT_EQUALS(red(7), 0);
+
+        TS_TRACE("Back to the base instance 0");
+        glClear(GL_COLOR_BUFFER_BIT);
+        gl_draw_instanced(vao, 3);
+        read();
+        TS_ASSERT(drawn_between(0, 3));
+        TS_ASSERT_EQUALS(red(0), 255);
+        TS_ASSERT_EQUALS(red(1), 255);
+        TS_ASSERT_EQUALS(red(2), 0);
+        TS_ASSERT_THROWS_NOTHING(priv::glTryError());
+    }
+
+    void testIntegerAttributes()
+    {
+        // 2^24 + 1 has no float representation: the values only match if they aren't converted.
+        gl_program program = make_test_program("#version 330\n"
+                                               "layout(location = 0) in vec3 position;\n"
+                                               "layout(location = 1) in uint id;\n"
+                                               "layout(location = 2) in int delta;\n"
+                                               "flat out int ok;\n"
+                                               "void main(void){ gl_Position = vec4(position, 1.0); ok = id == 16777217u && delta == -16777217 ? 1 : 0; }",
+                                               "#version 330\n"
+                                               "flat in int ok;\n"
+                                               "out vec4 color;\n"
+                                               "void main(void){ color = vec4(1 - ok, ok, 0.0, 1.0); }");
+        // One triangle covering the framebuffer.
+        gl_vector<draw_test::tagged> triangle = {
+            { glm::vec3(-1.f, -1.f, 0.f), 16777217u, -16777217 },
+            { glm::vec3(3.f, -1.f, 0.f), 16777217u, -16777217 },
+            { glm::vec3(-1.f, 3.f, 0.f), 16777217u, -16777217 }
+        };
+        // ------------------------- DECLARE ------------------------ //
+
+        program.use();
+        for(int located = 0; located < 2; ++located)
+        {
+            TS_TRACE(located ? "Locations of the program" : "Locations assigned at compile time");
+            gl_vao vao = located ? program.make_vao(triangle) : make_vao(triangle);
+            glClear(GL_COLOR_BUFFER_BIT);
+            gl_draw(vao);
+            read();
+            TS_ASSERT_EQUALS(red(3), 0);
+            TS_ASSERT(drawn(3));
+        }
+        TS_ASSERT_THROWS_NOTHING(priv::glTryError());
+    }
+
+    void testDrawIndirectBaseInstance()
+    {
+        gl_program program = make_program();
+        gl_vector<draw_test::vertex> quad = {
+            { glm::vec3(-1.f, -1.f, 0.f) }, { glm::vec3(-0.75f, -1.f, 0.f) },
+            { glm::vec3(-0.75f, -0.75f, 0.f) }, { glm::vec3(-1.f, -0.75f, 0.f) }
+        };
+        gl_vector<std::uint32_t> indices = { 0, 1, 2, 0, 2, 3 };
+        std::vector<draw_test::instance> diagonal;
+        for(int x = 0; x < 8; ++x)
+            diagonal.push_back(draw_test::instance{ glm::vec3(x * 0.25f, x * 0.25f, 0.f) });
+        gl_vector<draw_test::instance> offsets(diagonal.begin(), diagonal.end());
+        gl_vector<float> shades = { 0.f, 0.f, 0.f, 1.f, 1.f, 1.f, 0.f, 0.f };
+        gl_vao vao = make_vao(quad, indices, make_instanced(offsets),
+                              make_instanced(make_buffer(shades, "shade", 2)));
+        // The commands draw the instances 3 to 5, then the instance 0.
+        std::vector<draw_elements_indirect_command> commands = {
+            { 6, 3, 0, 0, 3 },
+            { 6, 1, 0, 0, 0 },
+        };
+        gl_vector<draw_elements_indirect_command> buffer(commands.begin(), commands.end());
+        // ------------------------- DECLARE ------------------------ //
+
+        program.use();
+        glClear(GL_COLOR_BUFFER_BIT);
+        TS_ASSERT_THROWS_NOTHING(gl_draw_indirect(vao, commands));
+        read();
+        TS_ASSERT(drawn(0) && !drawn(1) && !drawn(2) && !drawn(6));
+        TS_ASSERT_EQUALS(red(0), 0);
+        TS_ASSERT_EQUALS(red(3), 255);
+        TS_ASSERT_EQUALS(red(4), 255);
+        TS_ASSERT_EQUALS(red(5), 255);
+
+        TS_TRACE("The same commands from a buffer");
+        glClear(GL_COLOR_BUFFER_BIT);
+        TS_ASSERT_THROWS_NOTHING(gl_draw_indirect(vao, buffer));
+        read();
+        TS_ASSERT(drawn(0) && !drawn(1) && !drawn(2) && !drawn(6));
+        TS_ASSERT_EQUALS(red(0), 0);
+        TS_ASSERT_EQUALS(red(3), 255);
+        TS_ASSERT_EQUALS(red(5), 255);
+
+        TS_TRACE("The same commands from a shader storage buffer");
+        gl_vector<draw_elements_indirect_command, draw_test::storage_commands> storage(commands.begin(), commands.end());
+        glClear(GL_COLOR_BUFFER_BIT);
+        TS_ASSERT_THROWS_NOTHING(gl_draw_indirect(vao, storage));
+        read();
+        TS_ASSERT(drawn(0) && !drawn(1) && !drawn(2) && !drawn(6));
+        TS_ASSERT_EQUALS(red(4), 255);
+        TS_ASSERT_THROWS_NOTHING(priv::glTryError());
+    }
+};
+
+#endif /* GLDRAWPROPERUSE_H_ */
@@ -0,0 +1,115 @@
+#ifndef GLSTATECACHEPROPERUSE_H_
+#define GLSTATECACHEPROPERUSE_H_
+
+#include <cxxtest/TestSuite.h>
+
+#include "../mgl/glrequires.hpp"
+#include "../mgl/type/glstatecache.hpp"
+
+using namespace mgl;
+
+class GLStateCacheProperUse : public CxxTest::TestSuite
+{
+public:
+
+    void testRedundantBinds()
+    {
+        gl_state_cache cache;
+
+        TS_ASSERT_EQUALS(cache.change_program(3), true);
+        TS_ASSERT_EQUALS(cache.change_program(3), false);
+        TS_ASSERT_EQUALS(cache.change_buffer(GL_ARRAY_BUFFER, 5), true);
+        TS_ASSERT_EQUALS(cache.change_buffer(GL_ARRAY_BUFFER, 5), false);
+        TS_ASSERT_EQUALS(cache.change_sampler(0, 2), true);
+        TS_ASSERT_EQUALS(cache.change_sampler(1, 2), true);
+        TS_ASSERT_EQUALS(cache.change_sampler(0, 2), false);
+#ifndef MGL_NO_STATE_CACHE
+        TS_ASSERT_EQUALS(cache.issued(), 4u);
+        TS_ASSERT_EQUALS(cache.skipped(), 3u);
+#endif
+    }
+
+    void testVaoOwnsElementBuffer()
+    {
+        gl_state_cache cache;
+
+        cache.change_vao(1);
+        cache.change_buffer(GL_ELEMENT_ARRAY_BUFFER, 7);
+        TS_ASSERT_EQUALS(cache.change_buffer(GL_ELEMENT_ARRAY_BUFFER, 7), false);
+        cache.change_vao(2);
+        TS_ASSERT_EQUALS(cache.change_buffer(GL_ELEMENT_ARRAY_BUFFER, 7), true);
+    }
+
+    void testDeletedObjects()
+    {
+        gl_state_cache cache;
+        GLuint id = 5;
+
+        cache.change_buffer(GL_ARRAY_BUFFER, id);
+        cache.deleted_buffers(1, &id);
+        // The name can be reused by a new buffer.
+        TS_ASSERT_EQUALS(cache.change_buffer(GL_ARRAY_BUFFER, id), true);
+
+        cache.change_texture(0, GL_TEXTURE_2D, id);
+        cache.deleted_textures(1, &id);
+        TS_ASSERT_EQUALS(cache.change_texture(0, GL_TEXTURE_2D, id), true);
+
+        cache.change_program(id);
+        cache.deleted_program(id);
+        TS_ASSERT_EQUALS(cache.change_program(id), true);
+    }
+
+    void testEveryBufferTarget()
+    {
+        gl_state_cache cache;
+        const GLenum targets[] = {
+            GL_ARRAY_BUFFER, GL_ELEMENT_ARRAY_BUFFER, GL_UNIFORM_BUFFER, GL_SHADER_STORAGE_BUFFER,
+            GL_DRAW_INDIRECT_BUFFER, GL_DISPATCH_INDIRECT_BUFFER, GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+            GL_PIXEL_PACK_BUFFER, GL_PIXEL_UNPACK_BUFFER, GL_TEXTURE_BUFFER, GL_TRANSFORM_FEEDBACK_BUFFER,
+            GL_ATOMIC_COUNTER_BUFFER, GL_QUERY_BUFFER, GL_PARAMETER_BUFFER_ARB
+        };
+
+        for(GLenum target : targets)
+            TS_ASSERT_EQUALS(cache.change_buffer(target, 4), true);
+        // Each target keeps its own binding, however many have been met.
+        for(GLenum target : targets)
+            TS_ASSERT_EQUALS(cache.change_buffer(target, 4), false);
+    }
+
+    void testInvalidate()
+    {
+        gl_state_cache cache;
+
+        cache.change_program(3);
+        cache.invalidate();
+        TS_ASSERT_EQUALS(cache.change_program(3), true);
+    }
+
+    void testOptIn()
+    {
+        TS_TRACE("Until a cache is made current, every call is issued");
+        TS_ASSERT_EQUALS(gl_state_cache::current().change_program(3), true);
+        TS_ASSERT_EQUALS(gl_state_cache::current().change_program(3), true);
+
+        gl_state_cache cache;
+        cache.make_current();
+        TS_ASSERT_EQUALS(&gl_state_cache::current(), &cache);
+        gl_state_cache::reset_current();
+        TS_ASSERT(&gl_state_cache::current() != &cache);
+    }
+
+    void testDirectElementBuffer()
+    {
+        gl_state_cache cache;
+
+        cache.change_vao(1);
+        cache.change_buffer(GL_ELEMENT_ARRAY_BUFFER, 7);
+        cache.change_vao_element_buffer(2, 9);
+        TS_ASSERT_EQUALS(cache.change_buffer(GL_ELEMENT_ARRAY_BUFFER, 7), false);
+        cache.change_vao_element_buffer(1, 8);
+        TS_ASSERT_EQUALS(cache.change_buffer(GL_ELEMENT_ARRAY_BUFFER, 8), false);
+        TS_ASSERT_EQUALS(cache.change_buffer(GL_ELEMENT_ARRAY_BUFFER, 7), true);
+    }
+};
+
+#endif /* GLSTATECACHEPROPERUSE_H_ */
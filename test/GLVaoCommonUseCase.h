@@ -2,15 +2,212 @@
 #define GLVAOCOMMONUSECASE_H_
 
 #include <cxxtest/TestSuite.h>
+#include <SFML/Graphics.hpp>
+
 #include "../mgl/glrequires.hpp"
+#include "../mgl/gldata.hpp"
 #include "../mgl/gldraw.hpp"
+#include "../mgl/type/glshader.hpp"
+#include "../mgl/type/glvertexformat.hpp"
+
+MGL_DEFINE_GL_ATTRIBUTES((vao_test), vertex, (glm::vec3, position))
+
+using namespace mgl;
 
 class GLVaoCommonUseCase : public CxxTest::TestSuite
 {
+    std::unique_ptr<sf::Window> window;
 public:
+    void setUp()
+    {
+        sf::ContextSettings settings;
+        settings.majorVersion = 3;
+        settings.minorVersion = 3;
+
+        window.reset(new sf::Window(sf::VideoMode(800, 600), "OpenGL", sf::Style::Default, settings));
+        window->setVisible(false);
+
+        GLenum err = glewInit();
+        if (GLEW_OK != err)
+        {
+            std::cerr << "GLEW error: " << glewGetErrorString(err) << std::endl;
+        }
+    }
+
+    void tearDown()
+    {
+        window->close();
+        window.reset();
+    }
+
     void testVaoCreation()
     {
-        TS_TRACE("TODO Vao creation");
+        gl_vector<glm::vec3> offsets(4);
+        GLint enabled = 0;
+
+        TS_TRACE("Without program, a simple buffer needs a location");
+        TS_ASSERT_THROWS(make_vao(make_buffer(offsets, "offset")), gl_unknown_location&);
+
+        gl_vao vao = make_vao(make_buffer(offsets, "offset", 2));
+        TS_ASSERT_EQUALS(vao.size(), 4u);
+        vao.bind();
+        glGetVertexAttribiv(2, GL_VERTEX_ATTRIB_ARRAY_ENABLED, &enabled);
+        TS_ASSERT_EQUALS(enabled, GL_TRUE);
+        vao.unbind();
+        TS_ASSERT_THROWS_NOTHING(priv::glTryError());
+    }
+
+    void testBuffersFollowed()
+    {
+        std::unique_ptr<gl_vector<vao_test::vertex>> mesh(new gl_vector<vao_test::vertex>(3));
+        gl_vao vao;
+        {
+            // Neither the program nor the vector have to outlive the vao.
+            gl_shader shader(shader_type::VERTEX_SHADER);
+            shader.load_src("#version 330\nlayout(location = 0) in vec3 position;\nvoid main(void){gl_Position = vec4(position, 1.0);}");
+            gl_program program;
+            program.attach(shader);
+            program.link();
+            vao = program.make_vao(*mesh);
+        }
+        GLint location = 0;
+        GLint bound = 0;
+        TS_ASSERT_EQUALS(vao.size(), 3u);
+
+        TS_TRACE("The vector grows past its capacity, the vao follows its new buffer");
+        {
+            auto lock = bind_at_scope(*mesh);
+            mesh->resize(100);
+        }
+        TS_ASSERT_EQUALS(vao.size(), 100u);
+        vao.bind();
+        glGetVertexAttribiv(location, GL_VERTEX_ATTRIB_ARRAY_BUFFER_BINDING, &bound);
+        TS_ASSERT_EQUALS(GLuint(bound), mesh->id());
+        vao.unbind();
+
+        TS_TRACE("The vector is moved, then destroyed");
+        gl_vector<vao_test::vertex> moved(std::move(*mesh));
+        mesh.reset();
+        TS_ASSERT_EQUALS(vao.size(), 100u);
+        moved = gl_vector<vao_test::vertex>();
+        TS_ASSERT_EQUALS(vao.size(), 0u);
+        {
+            gl_vector<vao_test::vertex> gone(std::move(moved));
+        }
+        TS_ASSERT_EQUALS(vao.size(), 0u);
+        TS_ASSERT_THROWS_NOTHING(vao.bind());
+        vao.unbind();
+        TS_ASSERT_THROWS_NOTHING(priv::glTryError());
+    }
+
+    void testMoveAssignment()
+    {
+        gl_vector<vao_test::vertex> source(5);
+        gl_vector<vao_test::vertex> target(2);
+        gl_vao followed = make_vao(source);
+        gl_vao replaced = make_vao(target);
+        GLint bound = 0;
+        // ------------------------- DECLARE ------------------------ //
+
+        TS_TRACE("The vaos of the source follow the buffer, the ones of the target see an empty buffer");
+        target = std::move(source);
+        TS_ASSERT_EQUALS(followed.size(), 5u);
+        TS_ASSERT_EQUALS(replaced.size(), 0u);
+        followed.bind();
+        glGetVertexAttribiv(0, GL_VERTEX_ATTRIB_ARRAY_BUFFER_BINDING, &bound);
+        TS_ASSERT_EQUALS(GLuint(bound), target.id());
+        followed.unbind();
+
+        TS_TRACE("A new vector moved into the target doesn't reach the former vaos");
+        target = gl_vector<vao_test::vertex>(7);
+        TS_ASSERT_EQUALS(followed.size(), 0u);
+        TS_ASSERT_EQUALS(replaced.size(), 0u);
+        TS_ASSERT_THROWS_NOTHING(priv::glTryError());
+    }
+
+    void testVertexFormatCache()
+    {
+        gl_vertex_format_cache formats;
+        gl_vector<vao_test::vertex> mesh(3);
+        gl_vector<std::uint32_t> indices = { 0, 1, 2 };
+        gl_vao other = make_vao(mesh);
+        GLint binding = 0;
+        // ------------------------- DECLARE ------------------------ //
+
+        if(!GLEW_VERSION_4_3 && !GLEW_ARB_vertex_attrib_binding)
+        {
+            TS_WARN("The separate attribute format isn't supported, the test is skipped.");
+            return;
+        }
+
+        const gl_vertex_format& format = formats.bind(mesh, indices);
+        TS_ASSERT_EQUALS(formats.size(), 1u);
+
+        TS_TRACE("Another vao bound in between, the vertex format is bound again");
+        other.bind();
+        formats.bind(mesh, indices);
+        glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &binding);
+        TS_ASSERT_EQUALS(GLuint(binding), format.id());
+        TS_ASSERT_EQUALS(formats.size(), 1u);
+        gl_object_vertexarrays::gl_bind(0);
+        TS_ASSERT_THROWS_NOTHING(priv::glTryError());
+    }
+
+    void testPool()
+    {
+        gl_vao_pool pool;
+        gl_vector<vao_test::vertex> mesh(3);
+        gl_vao bound = make_vao(mesh);
+        GLint binding = 0;
+        GLint enabled = 0;
+        gl_types::uid recycled = 0;
+        // ------------------------- DECLARE ------------------------ //
+
+        TS_TRACE("A released vao gives its name back, the vao bound is left bound");
+        {
+            gl_vao vao = make_vao(pool, mesh);
+            recycled = vao.id();
+            TS_ASSERT_EQUALS(pool.live(), 1u);
+            bound.bind();
+        }
+        glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &binding);
+        TS_ASSERT_EQUALS(GLuint(binding), bound.id());
+        bound.unbind();
+        TS_ASSERT_EQUALS(pool.live(), 0u);
+        TS_ASSERT_EQUALS(pool.size_free(), 1u);
+
+        TS_TRACE("The name is recycled with the attributes disabled");
+        gl_types::uid id = pool.acquire();
+        TS_ASSERT_EQUALS(id, recycled);
+        gl_object_vertexarrays::gl_bind(id);
+        glGetVertexAttribiv(0, GL_VERTEX_ATTRIB_ARRAY_ENABLED, &enabled);
+        TS_ASSERT_EQUALS(enabled, GL_FALSE);
+        gl_object_vertexarrays::gl_bind(0);
+        pool.release(id, 0, 0);
+
+        TS_TRACE("Moves transfer the name, only the last owner releases it");
+        gl_vao first = make_vao(pool, mesh);
+        gl_vao second(std::move(first));
+        TS_ASSERT_EQUALS(first.id(), 0u);
+        TS_ASSERT_EQUALS(second.id(), recycled);
+        gl_vao third;
+        third = std::move(second);
+        TS_ASSERT_EQUALS(second.id(), 0u);
+        TS_ASSERT_EQUALS(pool.live(), 1u);
+        third = gl_vao();
+        TS_ASSERT_EQUALS(pool.live(), 0u);
+        TS_ASSERT_EQUALS(pool.peak(), 1u);
+
+        TS_TRACE("A vao failing on a missing location gives its name back and is left unbound");
+        gl_vector<glm::vec3> offsets(3);
+        TS_ASSERT_THROWS(make_vao(pool, mesh, make_buffer(offsets, "offset")), gl_unknown_location&);
+        glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &binding);
+        TS_ASSERT_EQUALS(binding, 0);
+        TS_ASSERT_EQUALS(pool.live(), 0u);
+
+        pool.shrink();
+        TS_ASSERT_EQUALS(pool.size_free(), 0u);
+        TS_ASSERT_THROWS_NOTHING(priv::glTryError());
     }
 };
 
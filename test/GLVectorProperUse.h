@@ -8,6 +8,7 @@
 #include <SFML/Graphics.hpp>
 #include <iostream>
 #include <functional>
+#include <algorithm>
 
 using namespace mgl;
 
@@ -136,6 +137,103 @@ public:
 #       endif
 	}
 
+	void testBulkAppend()
+	{
+        TS_TRACE("Appending large blocks, copied with streaming stores.");
+        std::vector<float> valid(100000);
+        for(std::size_t i = 0; i < valid.size(); ++i)
+            valid[i] = float(i);
+
+        gl_vector<float> test;
+        test.append(valid.data(), 10);
+        test.append(valid.data() + 10, valid.size() - 10);
+        TS_ASSERT_EQUALS(test.size(), valid.size());
+        TS_ASSERT_EQUALS(test.is_mapped(), false);
+
+        std::vector<float> twice(valid.size() / 2, -1.f);
+        test.write(1, twice.data(), twice.size());
+
+        auto lock = bind_at_scope(test);
+        TS_ASSERT_EQUALS(test[0], 0.f);
+        TS_ASSERT_EQUALS(test[1], -1.f);
+        TS_ASSERT_EQUALS(test[twice.size()], -1.f);
+        TS_ASSERT_EQUALS(test[twice.size() + 1], float(twice.size() + 1));
+        TS_ASSERT_EQUALS(test[valid.size() - 1], valid.back());
+        TS_ASSERT_THROWS_NOTHING(priv::glTryError());
+	}
+
+	void testDirectStateAccessPaths()
+	{
+        TS_TRACE("The buffers edited by name and the buffers bound hold the same data.");
+        if(!priv::has_direct_state_access())
+        {
+            TS_WARN("Direct state access isn't supported, the test is skipped.");
+            return;
+        }
+
+        std::vector<float> block(10, 7.0f), results[2];
+        for(bool dsa : { true, false })
+        {
+            priv::set_direct_state_access(dsa);
+            gl_vector<float> test = { 1.0f, 2.0f, 3.0f };
+            {
+                auto lock = bind_at_scope(test);
+                test[1] = 5.0f;
+                for(int i = 0; i < 20; ++i)
+                    test.push_back(float(i));
+            }
+            test.append(block.data(), block.size());
+            TS_ASSERT_EQUALS(test.is_mapped(), false);
+
+            std::vector<float>& read = results[dsa ? 0 : 1];
+            read.resize(test.size());
+            gl_object_buffer<gl_buffer_type<float>>::gl_bind(test.id());
+            glGetBufferSubData(GL_ARRAY_BUFFER, 0, read.size() * sizeof(float), read.data());
+            TS_ASSERT_THROWS_NOTHING(priv::glTryError());
+        }
+        priv::set_direct_state_access(true);
+
+        TS_ASSERT_EQUALS(results[0].size(), 33u);
+        TS_ASSERT_EQUALS(results[0][1], 5.0f);
+        TS_ASSERT_EQUALS(results[0][32], 7.0f);
+        TS_ASSERT(results[0] == results[1]);
+	}
+
+	void testAdaptiveUpload()
+	{
+        TS_TRACE("An adaptive vector rewritten every frame becomes a stream buffer.");
+        gl_upload_policy policy;
+        std::vector<std::string> logs;
+        TS_ASSERT(!policy.logger());
+        policy.set_logger([&logs](const std::string& p_message) { logs.push_back(p_message); });
+        policy.calibrate();
+        TS_ASSERT(policy.calibrated());
+        TS_ASSERT_EQUALS(logs.size(), 1u);
+
+        std::vector<float> valid(1024);
+        gl_vector<float> test(valid.size());
+        test.set_adaptive_upload(&policy);
+        for(std::uint64_t frame = 0; frame <= gl_upload_policy::window_frames; ++frame)
+        {
+            for(std::size_t i = 0; i < valid.size(); ++i)
+                valid[i] = float(frame + i);
+            test.update(0, valid.data(), valid.size());
+            policy.next_frame();
+        }
+        TS_ASSERT_EQUALS(test.usage(), GLenum(GL_STREAM_DRAW));
+        TS_ASSERT_EQUALS(test.upload_path(), policy.best(valid.size() * sizeof(float), true));
+        TS_ASSERT_EQUALS(logs.size(), 2u);
+
+        // The storage has been orphaned with the new usage, the content is kept by the updates.
+        test.update(1, valid.data(), 1);
+
+        auto lock = bind_at_scope(test);
+        TS_ASSERT_EQUALS(test[0], valid[0]);
+        TS_ASSERT_EQUALS(test[1], valid[0]);
+        TS_ASSERT_EQUALS(test[valid.size() - 1], valid.back());
+        TS_ASSERT_THROWS_NOTHING(priv::glTryError());
+	}
+
 };
 
 #endif /*GLVECTORPROPERUSE_H_*/
@@ -0,0 +1,133 @@
+#ifndef GPUCULLINGPROPERUSE_H_
+#define GPUCULLINGPROPERUSE_H_
+
+#include <cxxtest/TestSuite.h>
+#include <SFML/Graphics.hpp>
+
+#include <algorithm>
+#include "../mgl/glrequires.hpp"
+#include "../mgl/extension/gpu_culling.hpp"
+
+using namespace mgl;
+using namespace mgl::extension;
+
+class GPUCullingProperUse : public CxxTest::TestSuite
+{
+    std::unique_ptr<sf::Window> window;
+public:
+    void setUp()
+    {
+        sf::ContextSettings settings;
+        settings.majorVersion = 4;
+        settings.minorVersion = 3;
+
+        window.reset(new sf::Window(sf::VideoMode(800, 600), "OpenGL", sf::Style::Default, settings));
+        window->setVisible(false);
+
+        GLenum err = glewInit();
+        if (GLEW_OK != err)
+        {
+            std::cerr << "GLEW error: " << glewGetErrorString(err) << std::endl;
+        }
+    }
+
+    void tearDown()
+    {
+        window->close();
+        window.reset();
+    }
+
+    void testCullWritesCommands()
+    {
+        // Mesa llvmpipe has compute shaders, older drivers may not.
+        if(!mgl::priv::has_compute_shader())
+        {
+            TS_WARN("Compute shaders aren't supported, the test is skipped.");
+            return;
+        }
+
+        // The identity matrix gives the cube [-1, 1]^3.
+        frustum f = frustum::from_matrix(glm::mat4(1.f));
+        gl_vector<gpu_bounds> bounds = {
+            { glm::vec3(0.f, 0.f, 0.f), 0, glm::vec3(0.1f), 0.f },
+            { glm::vec3(5.f, 0.f, 0.f), 0, glm::vec3(0.1f), 0.f },
+            { glm::vec3(0.f, 1.05f, 0.f), 0, glm::vec3(0.1f), 0.f },
+            { glm::vec3(0.f, 0.f, -0.5f), 1, glm::vec3(0.1f), 0.f },
+            { glm::vec3(0.f, 0.f, -3.f), 1, glm::vec3(0.1f), 0.f },
+        };
+        // Mesh 0 owns the visible ids [0, 3[, mesh 1 the ids [3, 5[.
+        gl_vector<draw_elements_indirect_command> commands = {
+            { 36, 42, 0, 0, 0 },
+            { 6, 42, 36, 24, 3 },
+        };
+        gl_vector<std::uint32_t, gpu_visible_buffer> visible(bounds.size());
+
+        gpu_culler culler;
+        culler.cull(f, bounds, commands, visible);
+        TS_ASSERT_THROWS_NOTHING(mgl::priv::glTryError());
+
+        gl_scope<gl_vector<draw_elements_indirect_command>> mapped_commands(commands);
+        gl_scope<gl_vector<std::uint32_t, gpu_visible_buffer>> mapped_visible(visible);
+        TS_ASSERT_EQUALS(commands[0].instance_count, 2u);
+        TS_ASSERT_EQUALS(commands[0].count, 36u);
+        TS_ASSERT_EQUALS(commands[1].instance_count, 1u);
+        TS_ASSERT_EQUALS(commands[1].base_vertex, 24);
+        // The order inside a range depends on the scheduling.
+        std::vector<std::uint32_t> first(visible.begin(), visible.begin() + 2);
+        std::sort(first.begin(), first.end());
+        TS_ASSERT_EQUALS(first[0], 0u);
+        TS_ASSERT_EQUALS(first[1], 2u);
+        TS_ASSERT_EQUALS(visible[3], 3u);
+    }
+
+    void testHiZOccluder()
+    {
+        if(!mgl::priv::has_compute_shader())
+        {
+            TS_WARN("Compute shaders aren't supported, the test is skipped.");
+            return;
+        }
+
+        // A 4x4 pyramid: an occluder at depth 0.2 covers the left half, nothing covers the right half.
+        const float level0[16] = { 0.2f, 0.2f, 1.f, 1.f,  0.2f, 0.2f, 1.f, 1.f,
+                                   0.2f, 0.2f, 1.f, 1.f,  0.2f, 0.2f, 1.f, 1.f };
+        const float level1[4]  = { 0.2f, 1.f, 0.2f, 1.f };
+        const float level2[1]  = { 1.f };
+        gl_texture_2D hiz;
+        hiz.create();
+        hiz.bind(0);
+        glActiveTexture(GL_TEXTURE0);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_R32F, 4, 4, 0, GL_RED, GL_FLOAT, level0);
+        glTexImage2D(GL_TEXTURE_2D, 1, GL_R32F, 2, 2, 0, GL_RED, GL_FLOAT, level1);
+        glTexImage2D(GL_TEXTURE_2D, 2, GL_R32F, 1, 1, 0, GL_RED, GL_FLOAT, level2);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 2);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+        // With the identity matrix, the depth of z is z * 0.5 + 0.5.
+        frustum f = frustum::from_matrix(glm::mat4(1.f));
+        gl_vector<gpu_bounds> bounds = {
+            { glm::vec3(-0.5f, 0.f, 0.5f), 0, glm::vec3(0.1f), 0.f },   // behind the occluder
+            { glm::vec3(0.5f, 0.f, 0.5f), 0, glm::vec3(0.1f), 0.f },    // beside it
+            { glm::vec3(-0.5f, 0.f, -0.9f), 0, glm::vec3(0.05f), 0.f }, // in front of it
+        };
+        gl_vector<draw_elements_indirect_command> commands = {
+            { 36, 42, 0, 0, 0 },
+        };
+        gl_vector<std::uint32_t, gpu_visible_buffer> visible(bounds.size());
+
+        gpu_culler culler;
+        culler.cull(f, bounds, commands, visible, hiz, glm::mat4(1.f));
+        TS_ASSERT_THROWS_NOTHING(mgl::priv::glTryError());
+
+        gl_scope<gl_vector<draw_elements_indirect_command>> mapped_commands(commands);
+        gl_scope<gl_vector<std::uint32_t, gpu_visible_buffer>> mapped_visible(visible);
+        TS_ASSERT_EQUALS(commands[0].instance_count, 2u);
+        std::vector<std::uint32_t> ids(visible.begin(), visible.begin() + 2);
+        std::sort(ids.begin(), ids.end());
+        TS_ASSERT_EQUALS(ids[0], 1u);
+        TS_ASSERT_EQUALS(ids[1], 2u);
+    }
+};
+
+#endif /* GPUCULLINGPROPERUSE_H_ */
@@ -0,0 +1,131 @@
+#ifndef INSTANCEBATCHERPROPERUSE_H_
+#define INSTANCEBATCHERPROPERUSE_H_
+
+#include <cxxtest/TestSuite.h>
+
+#include "OffscreenTarget.h"
+#include "../mgl/gldata.hpp"
+#include "../mgl/extension/instance_batcher.hpp"
+
+MGL_DEFINE_GL_ATTRIBUTES((batcher_test), vertex, (glm::vec3, position)(glm::vec3, color))
+MGL_DEFINE_GL_ATTRIBUTES((batcher_test), instance, (glm::vec3, offset))
+
+using namespace mgl;
+using namespace mgl::extension;
+
+/*
+ * The draws are made in a 8x8 framebuffer, the instance data moves a quad over the pixel (x, x).
+ */
+class InstanceBatcherProperUse : public CxxTest::TestSuite
+{
+    std::unique_ptr<offscreen_target> target;
+public:
+    void setUp()
+    {
+        target.reset(new offscreen_target(3, 3));
+    }
+
+    void tearDown()
+    {
+        target.reset();
+    }
+
+    /*
+     * Returns a quad over the pixel (0, 0) of the passed color.
+     */
+    static gl_vector<batcher_test::vertex> make_quad(const glm::vec3& p_color)
+    {
+        return gl_vector<batcher_test::vertex>{
+            { glm::vec3(-1.f, -1.f, 0.f), p_color }, { glm::vec3(-0.75f, -1.f, 0.f), p_color },
+            { glm::vec3(-0.75f, -0.75f, 0.f), p_color }, { glm::vec3(-1.f, -0.75f, 0.f), p_color }
+        };
+    }
+
+    gl_program make_program()
+    {
+        return make_test_program("#version 330\n"
+                                 "in vec3 position;\n"
+                                 "in vec3 color;\n"
+                                 "in vec3 offset;\n"
+                                 "out vec3 c;\n"
+                                 "void main(void){ gl_Position = vec4(position + offset, 1.0); c = color; }",
+                                 "#version 330\n"
+                                 "in vec3 c;\n"
+                                 "out vec4 o;\n"
+                                 "void main(void){ o = vec4(c, 1.0); }");
+    }
+
+    void testOneDrawPerMesh()
+    {
+        gl_program program = make_program();
+        gl_vector<batcher_test::vertex> red   = make_quad(glm::vec3(1.f, 0.f, 0.f));
+        gl_vector<batcher_test::vertex> green = make_quad(glm::vec3(0.f, 1.f, 0.f));
+        gl_vector<std::uint32_t> indices = { 0, 1, 2, 0, 2, 3 };
+        instance_batcher<batcher_test::instance> batcher;
+        // ------------------------- DECLARE ------------------------ //
+
+        glClear(GL_COLOR_BUFFER_BIT);
+        for(int x = 0; x < 8; ++x)
+            batcher.draw(x % 2 ? green : red, indices, program, batcher_test::instance{ glm::vec3(x * 0.25f, x * 0.25f, 0.f) });
+        batcher.flush();
+        TS_ASSERT_EQUALS(batcher.size(), 2u);
+        TS_ASSERT_EQUALS(batcher.draw_calls(), 2u);
+        TS_ASSERT_EQUALS(batcher.instances(), 8u);
+
+        target->read();
+        for(int x = 0; x < 8; ++x)
+        {
+            TS_ASSERT_EQUALS(target->pixel(x, x)[0], x % 2 ? 0 : 255);
+            TS_ASSERT_EQUALS(target->pixel(x, x)[1], x % 2 ? 255 : 0);
+        }
+        TS_ASSERT_EQUALS(target->pixel(1, 0)[0] + target->pixel(1, 0)[1], 0);
+
+        TS_TRACE("The red quad grows, it keeps its batch");
+        {
+            auto lock = bind_at_scope(red);
+            red.resize(100);
+        }
+        batcher.draw(red, indices, program, batcher_test::instance{ glm::vec3(0.f) });
+        batcher.flush();
+        TS_ASSERT_EQUALS(batcher.size(), 2u);
+        TS_ASSERT_EQUALS(batcher.draw_calls(), 3u);
+        TS_ASSERT_EQUALS(batcher.instances(), 9u);
+        TS_ASSERT_THROWS_NOTHING(priv::glTryError());
+    }
+
+    void testEviction()
+    {
+        gl_program program = make_program();
+        gl_vector<batcher_test::vertex> red = make_quad(glm::vec3(1.f, 0.f, 0.f));
+        std::unique_ptr<gl_vector<batcher_test::vertex>> green(new gl_vector<batcher_test::vertex>(make_quad(glm::vec3(0.f, 1.f, 0.f))));
+        gl_vector<std::uint32_t> indices = { 0, 1, 2, 0, 2, 3 };
+        instance_batcher<batcher_test::instance> batcher(1);
+        // ------------------------- DECLARE ------------------------ //
+
+        batcher.draw(red, indices, program, batcher_test::instance{ glm::vec3(0.f) });
+        batcher.draw(*green, indices, program, batcher_test::instance{ glm::vec3(0.f) });
+        batcher.flush();
+        TS_ASSERT_EQUALS(batcher.size(), 2u);
+
+        TS_TRACE("A destroyed buffer evicts its batch, even with pending instances");
+        batcher.draw(*green, indices, program, batcher_test::instance{ glm::vec3(0.f) });
+        green.reset();
+        batcher.draw(red, indices, program, batcher_test::instance{ glm::vec3(0.f) });
+        batcher.flush();
+        TS_ASSERT_EQUALS(batcher.size(), 1u);
+        TS_ASSERT_EQUALS(batcher.draw_calls(), 3u);
+
+        TS_TRACE("A batch not drawn for more than one flush is evicted");
+        batcher.flush();
+        TS_ASSERT_EQUALS(batcher.size(), 1u);
+        batcher.flush();
+        TS_ASSERT_EQUALS(batcher.size(), 0u);
+        batcher.draw(red, indices, program, batcher_test::instance{ glm::vec3(0.f) });
+        batcher.flush();
+        TS_ASSERT_EQUALS(batcher.size(), 1u);
+        TS_ASSERT_EQUALS(batcher.draw_calls(), 4u);
+        TS_ASSERT_THROWS_NOTHING(priv::glTryError());
+    }
+};
+
+#endif /* INSTANCEBATCHERPROPERUSE_H_ */
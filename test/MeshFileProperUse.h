@@ -0,0 +1,97 @@
+#ifndef MESHFILEPROPERUSE_H_
+#define MESHFILEPROPERUSE_H_
+
+#include <cxxtest/TestSuite.h>
+#include <SFML/Graphics.hpp>
+#include <iostream>
+#include <sstream>
+
+#include "../mgl/glrequires.hpp"
+#include "../mgl/gldata.hpp"
+#include "../mgl/glscope.hpp"
+#include "../mgl/extension/mesh_file.hpp"
+
+MGL_DEFINE_GL_ATTRIBUTES((mesh_file_test), full, (float, x)(float, y)(float, z))
+MGL_DEFINE_GL_ATTRIBUTES((mesh_file_test), reordered, (float, z)(float, x))
+
+using namespace mgl;
+
+class MeshFileProperUse : public CxxTest::TestSuite
+{
+    std::unique_ptr<sf::Window> window;
+public:
+    void setUp()
+    {
+        sf::ContextSettings settings;
+        settings.majorVersion = 3;
+        settings.minorVersion = 3;
+
+        window.reset(new sf::Window(sf::VideoMode(800, 600), "OpenGL", sf::Style::Default, settings));
+        window->setVisible(false);
+
+        GLenum err = glewInit();
+        if (GLEW_OK != err)
+        {
+            std::cerr << "GLEW error: " << glewGetErrorString(err) << std::endl;
+        }
+    }
+
+    void tearDown()
+    {
+        window->close();
+        window.reset();
+    }
+
+    void testRoundTrip()
+    {
+        gl_vector<mesh_file_test::full> in = { { 1.f, 2.f, 3.f }, { 4.f, 5.f, 6.f } };
+        std::stringstream ss;
+        extension::write_mesh(ss, in);
+        std::string content = ss.str();
+
+        TS_TRACE("Same layout");
+        gl_vector<mesh_file_test::full> out;
+        TS_ASSERT_THROWS_NOTHING(extension::read_mesh(content.data(), content.size(), out));
+        TS_ASSERT_EQUALS(out.size(), 2u);
+        {
+            auto lock = bind_at_scope(out);
+            TS_ASSERT_EQUALS(out[1].x, 4.f);
+            TS_ASSERT_EQUALS(out[1].y, 5.f);
+        }
+
+        TS_TRACE("Different layout, the attributes are repacked");
+        gl_vector<mesh_file_test::reordered> repacked;
+        TS_ASSERT_THROWS_NOTHING(extension::read_mesh(content.data(), content.size(), repacked));
+        auto lock = bind_at_scope(repacked);
+        TS_ASSERT_EQUALS(repacked[1].x, 4.f);
+        TS_ASSERT_EQUALS(repacked[1].z, 6.f);
+    }
+
+    void testCorruptedFile()
+    {
+        gl_vector<mesh_file_test::full> out;
+        std::string garbage(32, 'x');
+        TS_ASSERT_THROWS(extension::read_mesh(garbage.data(), garbage.size(), out), gl_mesh_file_error&);
+
+        TS_TRACE("Sizes whose product overflows");
+        gl_vector<mesh_file_test::full> in = { { 1.f, 2.f, 3.f } };
+        std::stringstream ss;
+        extension::write_mesh(ss, in);
+        std::string content = ss.str();
+        extension::mesh_file_header header;
+        std::memcpy(&header, content.data(), sizeof(header));
+        header.element_count = std::uint64_t(1) << 60;
+        header.stride        = 16;
+        header.data_size     = 0;
+        std::memcpy(&content[0], &header, sizeof(header));
+        TS_ASSERT_THROWS(extension::read_mesh(content.data(), content.size(), out), gl_mesh_file_error&);
+
+        TS_TRACE("Null stride");
+        header.element_count = 1;
+        header.stride        = 0;
+        std::memcpy(&content[0], &header, sizeof(header));
+        TS_ASSERT_THROWS(extension::read_mesh(content.data(), content.size(), out), gl_mesh_file_error&);
+    }
+};
+
+#endif /*MESHFILEPROPERUSE_H_*/
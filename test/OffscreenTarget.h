@@ -0,0 +1,91 @@
+#ifndef OFFSCREENTARGET_H_
+#define OFFSCREENTARGET_H_
+
+#include <memory>
+#include <iostream>
+#include <SFML/Graphics.hpp>
+
+#include "../mgl/glrequires.hpp"
+#include "../mgl/type/glshader.hpp"
+#include "../mgl/type/glprogram.hpp"
+
+/*
+ * A hidden window whose context draws in a 8x8 framebuffer, shared by the suites checking
+ * their draws pixel by pixel. The framebuffer is cleared to black.
+ */
+class offscreen_target
+{
+    std::unique_ptr<sf::Window> window;
+    GLuint framebuffer;
+    GLuint renderbuffer;
+    unsigned char pixels[8 * 8 * 4];
+public:
+    offscreen_target(unsigned int p_major, unsigned int p_minor)
+        : framebuffer(0)
+        , renderbuffer(0)
+        , pixels()
+    {
+        sf::ContextSettings settings;
+        settings.majorVersion = p_major;
+        settings.minorVersion = p_minor;
+
+        window.reset(new sf::Window(sf::VideoMode(800, 600), "OpenGL", sf::Style::Default, settings));
+        window->setVisible(false);
+
+        GLenum err = glewInit();
+        if (GLEW_OK != err)
+        {
+            std::cerr << "GLEW error: " << glewGetErrorString(err) << std::endl;
+        }
+
+        glGenFramebuffers(1, &framebuffer);
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+        glGenRenderbuffers(1, &renderbuffer);
+        glBindRenderbuffer(GL_RENDERBUFFER, renderbuffer);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, 8, 8);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, renderbuffer);
+        glViewport(0, 0, 8, 8);
+        glClearColor(0.f, 0.f, 0.f, 1.f);
+    }
+
+    ~offscreen_target()
+    {
+        glDeleteRenderbuffers(1, &renderbuffer);
+        glDeleteFramebuffers(1, &framebuffer);
+        window->close();
+    }
+
+    /*
+     * Read back the framebuffer, for pixel().
+     */
+    void read()
+    {
+        glReadPixels(0, 0, 8, 8, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    }
+
+    /*
+     * Returns the RGBA channels of the pixel (x, y) at the last read().
+     */
+    const unsigned char* pixel(int x, int y) const
+    {
+        return pixels + (y * 8 + x) * 4;
+    }
+};
+
+/*
+ * Returns the linked program made of the passed vertex and fragment shaders.
+ */
+inline mgl::gl_program make_test_program(const char* p_vertex, const char* p_fragment)
+{
+    mgl::gl_shader vertex(mgl::shader_type::VERTEX_SHADER);
+    mgl::gl_shader fragment(mgl::shader_type::FRAGMENT_SHADER);
+    mgl::gl_program program;
+    vertex.load_src(p_vertex);
+    fragment.load_src(p_fragment);
+    program.attach(vertex);
+    program.attach(fragment);
+    program.link();
+    return program;
+}
+
+#endif /* OFFSCREENTARGET_H_ */
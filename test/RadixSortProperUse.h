@@ -0,0 +1,56 @@
+#ifndef RADIXSORTPROPERUSE_H_
+#define RADIXSORTPROPERUSE_H_
+
+#include <cxxtest/TestSuite.h>
+
+#include <random>
+#include <algorithm>
+#include "../mgl/extension/priv/radix_sort.hpp"
+
+using namespace mgl::extension::priv;
+
+class RadixSortProperUse : public CxxTest::TestSuite
+{
+public:
+
+    void testMatchesStableSort()
+    {
+        std::mt19937_64 random(42);
+        worker_pool pool(4);
+        std::vector<sort_item> items(100000), tmp;
+        for(std::size_t i = 0; i < items.size(); ++i)
+            // Many equal keys, to check the stability.
+            items[i] = sort_item{ i % 3 ? random() % 1000 : random(), static_cast<std::uint32_t>(i) };
+        std::vector<sort_item> expected(items);
+        std::stable_sort(expected.begin(), expected.end(),
+                         [](const sort_item& a, const sort_item& b) { return a.key < b.key; });
+
+        // The second sort reuses the threads of the first one.
+        for(int run = 0; run < 2; ++run)
+        {
+            std::vector<sort_item> shuffled(items);
+            radix_sort(shuffled, tmp, pool);
+            for(std::size_t i = 0; i < shuffled.size(); ++i)
+            {
+                TS_ASSERT_EQUALS(shuffled[i].key, expected[i].key);
+                TS_ASSERT_EQUALS(shuffled[i].index, expected[i].index);
+            }
+        }
+    }
+
+    void testSmallInputs()
+    {
+        worker_pool pool(4);
+        std::vector<sort_item> items, tmp;
+        radix_sort(items, tmp, pool);
+        TS_ASSERT(items.empty());
+
+        items = { { 3, 0 }, { 1, 1 }, { 2, 2 } };
+        radix_sort(items, tmp, pool);
+        TS_ASSERT_EQUALS(items[0].index, 1u);
+        TS_ASSERT_EQUALS(items[1].index, 2u);
+        TS_ASSERT_EQUALS(items[2].index, 0u);
+    }
+};
+
+#endif /* RADIXSORTPROPERUSE_H_ */
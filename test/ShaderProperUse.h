@@ -7,6 +7,7 @@
 #include "../mgl/glrequires.hpp"
 #include "../mgl/glvector.hpp"
 #include "../mgl/type/glshader.hpp"
+#include "../mgl/type/glprogram.hpp"
 #include "../mgl/glexceptions.hpp"
 
 using namespace mgl;
@@ -52,6 +53,21 @@ public:
         TS_ASSERT_THROWS_NOTHING(priv::glTryError());
     }
 
+    void testAttributeLocations()
+    {
+        // "a1039599" and "a1222382" have the same hash.
+        TS_ASSERT_EQUALS(priv::hash_str("a1039599"), priv::hash_str("a1222382"));
+        gl_shader shader(shader_type::VERTEX_SHADER);
+        shader.load_src("#version 330\nlayout(location = 3) in vec4 a1039599;\nvoid main(void){gl_Position = a1039599;}");
+        gl_program program;
+        program.attach(shader);
+        program.link();
+
+        TS_ASSERT_EQUALS(program.attribute_locations().find("a1039599"), 3);
+        TS_ASSERT_EQUALS(program.attribute_locations().find("a1222382"), -1);
+        TS_ASSERT_EQUALS(program.attribute_locations().find("vertex"), -1);
+    }
+
 };
 
 #endif /*SHADERPROPERUSE_H_*/
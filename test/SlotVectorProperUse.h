@@ -0,0 +1,83 @@
+#ifndef SLOTVECTORPROPERUSE_H_
+#define SLOTVECTORPROPERUSE_H_
+
+#include <cxxtest/TestSuite.h>
+#include <SFML/Graphics.hpp>
+
+#include "../mgl/glrequires.hpp"
+#include "../mgl/gldata.hpp"
+#include "../mgl/glscope.hpp"
+#include "../mgl/glslotvector.hpp"
+
+MGL_DEFINE_GL_ATTRIBUTES((slot_test), instance, (float, id)(glm::vec3, offset))
+
+using namespace mgl;
+
+class SlotVectorProperUse : public CxxTest::TestSuite
+{
+    std::unique_ptr<sf::Window> window;
+public:
+    void setUp()
+    {
+        sf::ContextSettings settings;
+        settings.majorVersion = 3;
+        settings.minorVersion = 3;
+
+        window.reset(new sf::Window(sf::VideoMode(800, 600), "OpenGL", sf::Style::Default, settings));
+        window->setVisible(false);
+
+        GLenum err = glewInit();
+        if (GLEW_OK != err)
+        {
+            std::cerr << "GLEW error: " << glewGetErrorString(err) << std::endl;
+        }
+    }
+
+    void tearDown()
+    {
+        window->close();
+        window.reset();
+    }
+
+    void testHandlesFollowElements()
+    {
+        gl_slot_vector<slot_test::instance> slots;
+        gl_slot_handle a = slots.insert({ 1.f, glm::vec3(0.f, 0.f, 0.f) });
+        gl_slot_handle b = slots.insert({ 2.f, glm::vec3(0.f, 0.f, 0.f) });
+        gl_slot_handle c = slots.insert({ 3.f, glm::vec3(0.f, 0.f, 0.f) });
+
+        TS_ASSERT(slots.erase(a));
+        TS_ASSERT(!slots.contains(a));
+        TS_ASSERT(!slots.erase(a));
+        TS_ASSERT_EQUALS(slots.size(), 2u);
+        TS_ASSERT_EQUALS(slots[b].id, 2.f);
+        TS_ASSERT_EQUALS(slots[c].id, 3.f);
+        TS_ASSERT_EQUALS(slots.position(c), 0u);
+
+        // The slot is reused, the stale handle is still rejected.
+        gl_slot_handle d = slots.insert({ 4.f, glm::vec3(0.f, 0.f, 0.f) });
+        TS_ASSERT_EQUALS(d.index, a.index);
+        TS_ASSERT(!slots.contains(a));
+        TS_ASSERT_EQUALS(slots[d].id, 4.f);
+    }
+
+    void testUploadOnlyDirty()
+    {
+        gl_slot_vector<slot_test::instance> slots;
+        std::vector<gl_slot_handle> handles;
+        for(int i = 0; i < 8; ++i)
+            handles.push_back(slots.insert({ float(i), glm::vec3(0.f, 0.f, 0.f) }));
+        TS_ASSERT_EQUALS(slots.upload(), 8u);
+        TS_ASSERT_EQUALS(slots.upload(), 0u);
+
+        slots.modify(handles[2]).id = 20.f;
+        slots.erase(handles[5]);
+        TS_ASSERT_EQUALS(slots.upload(), 2u);
+
+        gl_scope<gl_vector<slot_test::instance>> mapped(slots.buffer());
+        TS_ASSERT_EQUALS(slots.buffer()[2].id, 20.f);
+        TS_ASSERT_EQUALS(slots.buffer()[5].id, 7.f);
+    }
+};
+
+#endif /* SLOTVECTORPROPERUSE_H_ */